@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+namespace Arieo::Lib::WasmtimeLinker::Benchmark
+{
+    struct BenchmarkResult
+    {
+        std::string_view m_name;
+        uint64_t m_iterations = 0;
+        uint64_t m_total_nanoseconds = 0;
+        bool m_failed = false;
+
+        double getNanosecondsPerCall() const
+        {
+            return m_iterations ? double(m_total_nanoseconds) / double(m_iterations) : 0.0;
+        }
+
+        double getCallsPerSecond() const
+        {
+            return m_total_nanoseconds ? double(m_iterations) * 1e9 / double(m_total_nanoseconds) : 0.0;
+        }
+    };
+
+    // Time fn after one warm-up run, fn performs calls_per_run calls and returns false to abort.
+    // A run is typically one guest export looping over the host import, so the wasm entry is amortized.
+    template<typename Fn>
+    BenchmarkResult runBenchmark(std::string_view name, uint64_t runs, uint64_t calls_per_run, Fn&& fn)
+    {
+        BenchmarkResult result{name};
+        if (!fn()) {
+            std::fprintf(stderr, "%.*s failed during warm-up\n", static_cast<int>(name.size()), name.data());
+            result.m_failed = true;
+            return result;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t run = 0; run < runs; ++run) {
+            if (!fn()) {
+                std::fprintf(stderr, "%.*s failed after %llu runs\n", static_cast<int>(name.size()), name.data(), static_cast<unsigned long long>(run));
+                result.m_failed = true;
+                break;
+            }
+            result.m_iterations += calls_per_run;
+        }
+
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        result.m_total_nanoseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        return result;
+    }
+
+    inline void printBenchmarkResult(const BenchmarkResult& result)
+    {
+        std::printf("%-32.*s %12llu calls %10.2f ns/call %14.0f calls/s%s\n",
+            static_cast<int>(result.m_name.size()), result.m_name.data(),
+            static_cast<unsigned long long>(result.m_iterations),
+            result.getNanosecondsPerCall(), result.getCallsPerSecond(),
+            result.m_failed ? "  FAILED" : ""
+        );
+    }
+}
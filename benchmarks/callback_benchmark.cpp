@@ -0,0 +1,157 @@
+// Per-call cost of a host function with 0 to 8 scalar arguments, reported in ns/call for:
+//  - host:      the generated component callback invoked directly, dispatch and Val marshalling only
+//  - component: a component export looping over the lowered host import, the full canonical ABI round trip
+//  - core:      a core module export looping over the import defined by defineCoreWasmExports
+// Usage: arieo_wasmtime_linker_callback_benchmark [runs] [calls-per-run]
+
+#include "benchmark_support.h"
+#include "callback_benchmark_fixture.h"
+#include "lib/wasmtime_linker/component_instance_pre.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Arieo::Lib::WasmtimeLinker;
+using namespace Arieo::Lib::WasmtimeLinker::Benchmark;
+
+namespace
+{
+    const InterfaceFunctionExportInfo* findFunctionExportInfo(const LinkerExportInfo& linker_export_info, std::string_view function_name)
+    {
+        const InterfaceExportInfo& interface_info = linker_export_info.m_interface_array[0];
+        for (size_t i = 0; i < interface_info.m_member_function_count; ++i) {
+            if (function_name == interface_info.m_member_function_array[i].m_function_name) {
+                return &interface_info.m_member_function_array[i];
+            }
+        }
+        return nullptr;
+    }
+
+    std::vector<wasmtime::component::Val> makeHostArgs(CallbackBenchmarkInstanceArg instance_value, uint32_t arity)
+    {
+        std::vector<wasmtime::component::Val> args;
+        args.reserve(arity + 1);
+        args.emplace_back(makeComponentInstanceVal(instance_value));
+        for (uint32_t i = 0; i < arity; ++i) {
+            args.emplace_back(static_cast<int32_t>(i + 1));
+        }
+        return args;
+    }
+
+    uint64_t parseCount(int argc, char** argv, int index, uint64_t default_value)
+    {
+        return argc > index ? std::strtoull(argv[index], nullptr, 10) : default_value;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const uint64_t runs = parseCount(argc, argv, 1, 100);
+    const uint64_t calls_per_run = parseCount(argc, argv, 2, 10000);
+
+    wasmtime::Engine engine;
+    const LinkerExportInfo& linker_export_info = *LinkerExportInfoRegister<CallbackBenchmarkInterface>::generateLinkerExportInfo();
+
+    auto component_bytes = wasmtime::wat2wasm(makeComponentBenchmarkWat());
+    if (!component_bytes) {
+        std::fprintf(stderr, "Failed to assemble the component fixture: %s\n", component_bytes.err().message().c_str());
+        return 1;
+    }
+    auto component = wasmtime::component::Component::compile(engine, component_bytes.ok());
+    if (!component) {
+        std::fprintf(stderr, "Failed to compile the component fixture: %s\n", component.err().message().c_str());
+        return 1;
+    }
+    auto instance_pre = ComponentInstancePre::create(engine, component.unwrap(), linker_export_info);
+    if (!instance_pre) {
+        std::fprintf(stderr, "Failed to link the component fixture: %s\n", instance_pre.err().message().c_str());
+        return 1;
+    }
+
+    wasmtime::Linker core_linker(engine);
+    auto core_defined = defineCoreWasmExports(core_linker, linker_export_info);
+    auto core_module = wasmtime::Module::compile(engine, makeCoreBenchmarkWat());
+    if (!core_defined || !core_module) {
+        std::fprintf(stderr, "Failed to build the core module fixture\n");
+        return 1;
+    }
+
+    wasmtime::Store component_store(engine);
+    auto component_instance = instance_pre.ok().instantiate(component_store.context());
+    wasmtime::Store core_store(engine);
+    auto core_instance = core_linker.instantiate(core_store.context(), core_module.ok());
+    if (!component_instance || !core_instance) {
+        std::fprintf(stderr, "Failed to instantiate the fixtures\n");
+        return 1;
+    }
+
+    CallbackBenchmarkInterface host;
+    const CallbackBenchmarkInstanceArg instance_value = bindCallbackBenchmarkInstance(host);
+
+    std::printf("%llu runs x %llu calls per arity\n", static_cast<unsigned long long>(runs), static_cast<unsigned long long>(calls_per_run));
+    for (uint32_t arity = 0; arity <= MaxCallbackBenchmarkArity; ++arity) {
+        const std::string function_name = "call" + std::to_string(arity);
+        const std::string export_name = makeRunExportName(arity);
+
+        const InterfaceFunctionExportInfo* function_info = findFunctionExportInfo(linker_export_info, function_name);
+        auto func_type = findImportedFuncType(engine, instance_pre.ok().getComponent(), CallbackBenchmarkInterfaceName, function_name);
+        if (!function_info || !func_type) {
+            std::fprintf(stderr, "Missing export info or import type for %s\n", function_name.c_str());
+            return 1;
+        }
+
+        std::vector<wasmtime::component::Val> host_args = makeHostArgs(instance_value, arity);
+        std::vector<wasmtime::component::Val> host_results{wasmtime::component::Val(int32_t(0))};
+        const std::string host_name = "host " + function_name;
+        printBenchmarkResult(runBenchmark(host_name, runs, calls_per_run,
+            [&]()
+            {
+                for (uint64_t i = 0; i < calls_per_run; ++i) {
+                    if (!function_info->m_host_callback(component_store.context(), *func_type, host_args, host_results)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        ));
+
+        auto export_index = component_instance.ok().get_export_index(component_store.context(), nullptr, export_name);
+        auto component_func = export_index ? component_instance.ok().get_func(component_store.context(), *export_index) : std::nullopt;
+        if (!component_func) {
+            std::fprintf(stderr, "Component fixture does not export %s\n", export_name.c_str());
+            return 1;
+        }
+        const std::vector<wasmtime::component::Val> component_args{
+            makeComponentInstanceVal(instance_value), wasmtime::component::Val(static_cast<int32_t>(calls_per_run))
+        };
+        std::vector<wasmtime::component::Val> component_results{wasmtime::component::Val(int32_t(0))};
+        const std::string component_name = "component " + function_name;
+        printBenchmarkResult(runBenchmark(component_name, runs, calls_per_run,
+            [&]()
+            {
+                return component_func->call(component_store.context(), component_args, component_results) 
+                    && component_func->post_return(component_store.context());
+            }
+        ));
+
+        auto core_export = core_instance.ok().get(core_store.context(), export_name);
+        const wasmtime::Func* core_func = core_export ? std::get_if<wasmtime::Func>(&*core_export) : nullptr;
+        if (!core_func) {
+            std::fprintf(stderr, "Core fixture does not export %s\n", export_name.c_str());
+            return 1;
+        }
+        const std::vector<wasmtime::Val> core_args{makeCoreInstanceVal(instance_value), wasmtime::Val(static_cast<int32_t>(calls_per_run))};
+        const std::string core_name = "core " + function_name;
+        printBenchmarkResult(runBenchmark(core_name, runs, calls_per_run,
+            [&]()
+            {
+                return static_cast<bool>(core_func->call(core_store.context(), core_args));
+            }
+        ));
+    }
+
+    unbindCallbackBenchmarkInstance(instance_value);
+    return 0;
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "lib/wasmtime_linker/interface_wasmtime_linker.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace Arieo::Lib::WasmtimeLinker::Benchmark
+{
+    // Synthetic host interface with 0 to 8 scalar arguments, only the arity changes between member functions so the
+    // measured difference between them is the per-argument marshalling cost
+    struct CallbackBenchmarkInterface
+    {
+        int32_t call0() { return ++m_call_count; }
+        int32_t call1(int32_t a0) { ++m_call_count; return a0; }
+        int32_t call2(int32_t a0, int32_t a1) { ++m_call_count; return a0 + a1; }
+        int32_t call3(int32_t a0, int32_t a1, int32_t a2) { ++m_call_count; return a0 + a1 + a2; }
+        int32_t call4(int32_t a0, int32_t a1, int32_t a2, int32_t a3) { ++m_call_count; return a0 + a1 + a2 + a3; }
+        int32_t call5(int32_t a0, int32_t a1, int32_t a2, int32_t a3, int32_t a4)
+        {
+            ++m_call_count;
+            return a0 + a1 + a2 + a3 + a4;
+        }
+        int32_t call6(int32_t a0, int32_t a1, int32_t a2, int32_t a3, int32_t a4, int32_t a5)
+        {
+            ++m_call_count;
+            return a0 + a1 + a2 + a3 + a4 + a5;
+        }
+        int32_t call7(int32_t a0, int32_t a1, int32_t a2, int32_t a3, int32_t a4, int32_t a5, int32_t a6)
+        {
+            ++m_call_count;
+            return a0 + a1 + a2 + a3 + a4 + a5 + a6;
+        }
+        int32_t call8(int32_t a0, int32_t a1, int32_t a2, int32_t a3, int32_t a4, int32_t a5, int32_t a6, int32_t a7)
+        {
+            ++m_call_count;
+            return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7;
+        }
+
+        int32_t m_call_count = 0;
+    };
+
+    inline constexpr std::string_view CallbackBenchmarkInterfaceName = "arieo:benchmark/callback";
+    inline constexpr uint32_t MaxCallbackBenchmarkArity = 8;
+}
+
+template<>
+struct Arieo::Base::InterfaceInfo<Arieo::Lib::WasmtimeLinker::Benchmark::CallbackBenchmarkInterface>
+{
+    using Interface = Arieo::Lib::WasmtimeLinker::Benchmark::CallbackBenchmarkInterface;
+
+    static constexpr std::string_view getWitFullInterfaceName() { return Arieo::Lib::WasmtimeLinker::Benchmark::CallbackBenchmarkInterfaceName; }
+    static constexpr std::size_t getMemberFunctionCount() { return 9; }
+    static constexpr std::uint64_t getInterfaceId() { return 0x62656e6368000001ull; }
+    static constexpr std::uint64_t getInterfaceChecksum() { return 1; }
+
+    template<typename Fn>
+    static void iteratorMemberFunctions(Fn&& fn)
+    {
+        fn(&Interface::call0, "call0", "call0", 1, 1);
+        fn(&Interface::call1, "call1", "call1", 2, 1);
+        fn(&Interface::call2, "call2", "call2", 3, 1);
+        fn(&Interface::call3, "call3", "call3", 4, 1);
+        fn(&Interface::call4, "call4", "call4", 5, 1);
+        fn(&Interface::call5, "call5", "call5", 6, 1);
+        fn(&Interface::call6, "call6", "call6", 7, 1);
+        fn(&Interface::call7, "call7", "call7", 8, 1);
+        fn(&Interface::call8, "call8", "call8", 9, 1);
+    }
+};
+
+namespace Arieo::Lib::WasmtimeLinker::Benchmark
+{
+    using CallbackBenchmarkInstanceArg = InstanceArgType<CallbackBenchmarkInterface>;
+    inline constexpr bool CallbackBenchmarkUsesHandles = InterfaceInstanceBinding<CallbackBenchmarkInterface>::use_handle_table;
+
+    // Guest value of the instance argument for host, registering it in the handle table when handles are enabled
+    inline CallbackBenchmarkInstanceArg bindCallbackBenchmarkInstance(CallbackBenchmarkInterface& host)
+    {
+        if constexpr (CallbackBenchmarkUsesHandles) {
+            return getInterfaceHandleTable<CallbackBenchmarkInterface>().insert(&host);
+        } else {
+            return static_cast<CallbackBenchmarkInstanceArg>(reinterpret_cast<intptr_t>(&host));
+        }
+    }
+
+    inline void unbindCallbackBenchmarkInstance(CallbackBenchmarkInstanceArg instance_value)
+    {
+        if constexpr (CallbackBenchmarkUsesHandles) {
+            getInterfaceHandleTable<CallbackBenchmarkInterface>().remove(instance_value);
+        }
+    }
+
+    // Guest exports "run-call<N>"(instance, n) -> s32 call the host import "call<N>" n times with constant
+    // arguments, so one wasm entry amortizes over n host calls
+    inline std::string makeRunExportName(uint32_t arity)
+    {
+        return "run-call" + std::to_string(arity);
+    }
+
+    namespace Detail
+    {
+        inline std::string makeCoreImportType(uint32_t arity)
+        {
+            std::string type = CallbackBenchmarkUsesHandles ? "(param i32" : "(param i64";
+            for (uint32_t i = 0; i < arity; ++i) {
+                type += " i32";
+            }
+            return type + ") (result i32)";
+        }
+
+        inline std::string makeCoreRunFunction(uint32_t arity)
+        {
+            const std::string index = std::to_string(arity);
+            std::string args = "(local.get $instance)";
+            for (uint32_t i = 0; i < arity; ++i) {
+                args += " (i32.const " + std::to_string(i + 1) + ")";
+            }
+
+            return std::string("  (func (export \"") + makeRunExportName(arity) + "\") (param $instance " 
+                + (CallbackBenchmarkUsesHandles ? "i32" : "i64") + ") (param $n i32) (result i32)\n"
+                "    (local $acc i32)\n"
+                "    (block $done\n"
+                "      (loop $next\n"
+                "        (br_if $done (i32.eqz (local.get $n)))\n"
+                "        (local.set $acc (i32.add (local.get $acc) (call $call" + index + " " + args + ")))\n"
+                "        (local.set $n (i32.sub (local.get $n) (i32.const 1)))\n"
+                "        (br $next)))\n"
+                "    (local.get $acc))\n";
+        }
+
+        // The loop module shared by both fixtures, importing every callN from import_module
+        inline std::string makeCoreLoopModule(std::string_view module_header, std::string_view import_module)
+        {
+            std::string wat = std::string(module_header) + "\n";
+            for (uint32_t arity = 0; arity <= MaxCallbackBenchmarkArity; ++arity) {
+                const std::string index = std::to_string(arity);
+                wat += "  (import \"" + std::string(import_module) + "\" \"call" + index + "\" (func $call" + index + " " 
+                    + makeCoreImportType(arity) + "))\n";
+            }
+            for (uint32_t arity = 0; arity <= MaxCallbackBenchmarkArity; ++arity) {
+                wat += makeCoreRunFunction(arity);
+            }
+            return wat + ")\n";
+        }
+    }
+
+    // Core module importing the host functions as defineCoreWasmExports declares them
+    inline std::string makeCoreBenchmarkWat()
+    {
+        return Detail::makeCoreLoopModule("(module", CallbackBenchmarkInterfaceName);
+    }
+
+    // Component importing the interface instance, the same loop module runs on the lowered imports and every
+    // run-callN is lifted as a component export
+    inline std::string makeComponentBenchmarkWat()
+    {
+        const char* instance_type = CallbackBenchmarkUsesHandles ? "u32" : "s64";
+        std::string wat = "(component\n  (import \"" + std::string(CallbackBenchmarkInterfaceName) + "\" (instance $host\n";
+        for (uint32_t arity = 0; arity <= MaxCallbackBenchmarkArity; ++arity) {
+            wat += "    (export \"call" + std::to_string(arity) + "\" (func (param \"instance\" " + instance_type + ")";
+            for (uint32_t i = 0; i < arity; ++i) {
+                wat += " (param \"a" + std::to_string(i) + "\" s32)";
+            }
+            wat += " (result s32)))\n";
+        }
+        wat += "  ))\n";
+
+        for (uint32_t arity = 0; arity <= MaxCallbackBenchmarkArity; ++arity) {
+            const std::string index = std::to_string(arity);
+            wat += "  (core func $lowered" + index + " (canon lower (func $host \"call" + index + "\")))\n";
+        }
+
+        wat += Detail::makeCoreLoopModule("  (core module $loop", "host");
+
+        wat += "  (core instance $loop_instance (instantiate $loop (with \"host\" (instance\n";
+        for (uint32_t arity = 0; arity <= MaxCallbackBenchmarkArity; ++arity) {
+            const std::string index = std::to_string(arity);
+            wat += "    (export \"call" + index + "\" (func $lowered" + index + "))\n";
+        }
+        wat += "  ))))\n";
+
+        for (uint32_t arity = 0; arity <= MaxCallbackBenchmarkArity; ++arity) {
+            wat += "  (func (export \"" + makeRunExportName(arity) + "\") (param \"instance\" " + instance_type 
+                + ") (param \"n\" s32) (result s32) (canon lift (core func $loop_instance \"" + makeRunExportName(arity) + "\")))\n";
+        }
+        return wat + ")\n";
+    }
+
+    // Component instance argument for the guest
+    inline wasmtime::component::Val makeComponentInstanceVal(CallbackBenchmarkInstanceArg instance_value)
+    {
+        return wasmtime::component::Val(instance_value);
+    }
+
+    inline wasmtime::Val makeCoreInstanceVal(CallbackBenchmarkInstanceArg instance_value)
+    {
+        if constexpr (CallbackBenchmarkUsesHandles) {
+            return wasmtime::Val(static_cast<int32_t>(instance_value));
+        } else {
+            return wasmtime::Val(static_cast<int64_t>(instance_value));
+        }
+    }
+}
@@ -0,0 +1,155 @@
+// Throughput of the store-per-worker execution model as threads are added: one shared Engine and
+// ComponentInstancePre, one ComponentWorker (store, scratch arena) per thread, every thread looping over the same
+// guest export. Reports aggregate calls/s and the scaling efficiency against the single-thread rate.
+// Usage: arieo_wasmtime_linker_worker_scaling_benchmark [max-threads] [runs] [calls-per-run]
+
+#include "benchmark_support.h"
+#include "callback_benchmark_fixture.h"
+#include "lib/wasmtime_linker/component_worker_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Arieo::Lib::WasmtimeLinker;
+using namespace Arieo::Lib::WasmtimeLinker::Benchmark;
+
+namespace
+{
+    // Arity of the host function every worker calls, four arguments keep marshalling in the measured path
+    constexpr uint32_t ScalingBenchmarkArity = 4;
+
+    uint64_t parseCount(int argc, char** argv, int index, uint64_t default_value)
+    {
+        return argc > index ? std::strtoull(argv[index], nullptr, 10) : default_value;
+    }
+
+    // Run the export on thread_count workers at once, returns the wall time from the common start to the last
+    // worker finishing, or zero when a worker failed
+    uint64_t runWorkers(
+        wasmtime::Engine& engine,
+        const std::shared_ptr<const ComponentInstancePre>& instance_pre,
+        size_t thread_count,
+        uint64_t runs,
+        uint64_t calls_per_run)
+    {
+        ComponentWorkerPool worker_pool(engine, instance_pre, thread_count);
+        std::barrier start_barrier(static_cast<std::ptrdiff_t>(thread_count + 1));
+        std::atomic<bool> failed{false};
+
+        std::vector<std::thread> threads;
+        threads.reserve(thread_count);
+        for (size_t worker_index = 0; worker_index < thread_count; ++worker_index) {
+            threads.emplace_back([&, worker_index]()
+            {
+                ComponentWorker& worker = worker_pool.getWorker(worker_index);
+                ScopedInterfaceScratchArena scoped_arena(worker.getScratchArena());
+
+                // Host objects are not shared, so the measurement contains no contention of its own
+                CallbackBenchmarkInterface host;
+                const CallbackBenchmarkInstanceArg instance_value = bindCallbackBenchmarkInstance(host);
+
+                auto instance = worker.instantiate();
+                auto export_index = instance 
+                    ? instance.ok().get_export_index(worker.getStoreContext(), nullptr, makeRunExportName(ScalingBenchmarkArity)) 
+                    : std::nullopt;
+                auto func = export_index ? instance.ok().get_func(worker.getStoreContext(), *export_index) : std::nullopt;
+                if (!func) {
+                    failed.store(true, std::memory_order_relaxed);
+                }
+
+                const std::vector<wasmtime::component::Val> args{
+                    makeComponentInstanceVal(instance_value), wasmtime::component::Val(static_cast<int32_t>(calls_per_run))
+                };
+                std::vector<wasmtime::component::Val> results{wasmtime::component::Val(int32_t(0))};
+
+                start_barrier.arrive_and_wait();
+                for (uint64_t run = 0; func && run < runs; ++run) {
+                    if (!func->call(worker.getStoreContext(), args, results) || !func->post_return(worker.getStoreContext())) {
+                        failed.store(true, std::memory_order_relaxed);
+                        break;
+                    }
+                }
+
+                unbindCallbackBenchmarkInstance(instance_value);
+            });
+        }
+
+        start_barrier.arrive_and_wait();
+        const auto start = std::chrono::steady_clock::now();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        if (failed.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const uint64_t max_threads = parseCount(argc, argv, 1, std::max<uint64_t>(1, std::thread::hardware_concurrency()));
+    const uint64_t runs = parseCount(argc, argv, 2, 100);
+    const uint64_t calls_per_run = parseCount(argc, argv, 3, 10000);
+
+    wasmtime::Engine engine;
+    const LinkerExportInfo& linker_export_info = *LinkerExportInfoRegister<CallbackBenchmarkInterface>::generateLinkerExportInfo();
+
+    auto component_bytes = wasmtime::wat2wasm(makeComponentBenchmarkWat());
+    if (!component_bytes) {
+        std::fprintf(stderr, "Failed to assemble the component fixture: %s\n", component_bytes.err().message().c_str());
+        return 1;
+    }
+    auto component = wasmtime::component::Component::compile(engine, component_bytes.ok());
+    if (!component) {
+        std::fprintf(stderr, "Failed to compile the component fixture: %s\n", component.err().message().c_str());
+        return 1;
+    }
+    auto instance_pre = ComponentInstancePre::create(engine, component.unwrap(), linker_export_info);
+    if (!instance_pre) {
+        std::fprintf(stderr, "Failed to link the component fixture: %s\n", instance_pre.err().message().c_str());
+        return 1;
+    }
+    const auto shared_instance_pre = std::make_shared<const ComponentInstancePre>(instance_pre.unwrap());
+
+    std::printf("call%u, %llu runs x %llu calls per thread\n", ScalingBenchmarkArity,
+        static_cast<unsigned long long>(runs), static_cast<unsigned long long>(calls_per_run));
+    std::printf("%8s %16s %14s %12s\n", "threads", "calls/s", "ns/call", "efficiency");
+
+    // Powers of two up to max_threads, plus max_threads itself
+    std::vector<uint64_t> thread_counts;
+    for (uint64_t thread_count = 1; thread_count < max_threads; thread_count *= 2) {
+        thread_counts.push_back(thread_count);
+    }
+    thread_counts.push_back(max_threads);
+
+    double single_thread_rate = 0.0;
+    for (uint64_t thread_count : thread_counts) {
+        const uint64_t elapsed_nanoseconds = runWorkers(engine, shared_instance_pre, thread_count, runs, calls_per_run);
+        if (elapsed_nanoseconds == 0) {
+            std::fprintf(stderr, "A worker failed with %llu threads\n", static_cast<unsigned long long>(thread_count));
+            return 1;
+        }
+
+        const double total_calls = double(thread_count) * double(runs) * double(calls_per_run);
+        const double calls_per_second = total_calls * 1e9 / double(elapsed_nanoseconds);
+        if (thread_count == 1) {
+            single_thread_rate = calls_per_second;
+        }
+        // Per-thread cost: wall time over the calls each thread made, flat under linear scaling
+        const double nanoseconds_per_call = double(elapsed_nanoseconds) / (double(runs) * double(calls_per_run));
+        const double efficiency = single_thread_rate > 0.0 ? calls_per_second / (single_thread_rate * double(thread_count)) : 0.0;
+        std::printf("%8llu %16.0f %14.2f %11.1f%%\n", static_cast<unsigned long long>(thread_count), 
+            calls_per_second, nanoseconds_per_call, efficiency * 100.0);
+    }
+    return 0;
+}
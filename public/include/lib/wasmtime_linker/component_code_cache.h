@@ -0,0 +1,146 @@
+#pragma once
+
+#include "lib/wasmtime_linker/interface_wasmtime_linker.h"
+
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace Arieo::Lib::WasmtimeLinker 
+{
+    // On-disk cache of compiled components. Entries are keyed on the component bytes plus every interface and
+    // function checksum of the LinkerExportInfo, so an ABI change of any host interface misses the cache.
+    // Cached artifacts are native code loaded without verification, the cache directory must be trusted.
+    class ComponentCodeCache
+    {
+    public:
+        explicit ComponentCodeCache(std::filesystem::path cache_directory)
+            : m_cache_directory(std::move(cache_directory))
+        {
+        }
+
+        static uint64_t computeCacheKey(wasmtime::Span<const uint8_t> component_bytes, const LinkerExportInfo& linker_export_info)
+        {
+            uint64_t hash = FnvOffsetBasis;
+            hashBytes(hash, component_bytes.data(), component_bytes.size());
+            for (size_t i = 0; i < linker_export_info.m_interface_count; ++i) {
+                const InterfaceExportInfo& interface_info = linker_export_info.m_interface_array[i];
+                hashValue(hash, interface_info.m_interaface_id);
+                hashValue(hash, interface_info.m_interface_checksum);
+                for (size_t j = 0; j < interface_info.m_member_function_count; ++j) {
+                    hashValue(hash, interface_info.m_member_function_array[j].m_function_id);
+                    hashValue(hash, interface_info.m_member_function_array[j].m_function_checksum);
+                }
+            }
+            return hash;
+        }
+
+        std::filesystem::path getCachePath(uint64_t cache_key) const
+        {
+            char file_name[32];
+            std::snprintf(file_name, sizeof(file_name), "%016llx.cwasm", static_cast<unsigned long long>(cache_key));
+            return m_cache_directory / file_name;
+        }
+
+        // Deserialize (memory-mapped by wasmtime) a cached artifact, or compile the component and store it.
+        // An artifact from an incompatible engine configuration or wasmtime version fails to load and is recompiled.
+        wasmtime::Result<wasmtime::component::Component> loadOrCompile(
+            wasmtime::Engine& engine, 
+            wasmtime::Span<const uint8_t> component_bytes, 
+            const LinkerExportInfo& linker_export_info) const
+        {
+            const std::filesystem::path cache_path = getCachePath(computeCacheKey(component_bytes, linker_export_info));
+            
+            std::error_code error_code;
+            if (std::filesystem::exists(cache_path, error_code)) {
+                auto cached = wasmtime::component::Component::deserialize_file(engine, cache_path.string());
+                if (cached) {
+                    return cached;
+                }
+                Core::Logger::warn("Discarding stale component cache entry {}: {}", cache_path.string(), cached.err().message());
+            }
+            
+            auto compiled = wasmtime::component::Component::compile(engine, component_bytes);
+            if (!compiled) {
+                return compiled;
+            }
+            
+            store(cache_path, compiled.ok());
+            return compiled;
+        }
+
+    private:
+        static constexpr uint64_t FnvOffsetBasis = 0xcbf29ce484222325ull;
+        static constexpr uint64_t FnvPrime = 0x100000001b3ull;
+
+        static void hashBytes(uint64_t& hash, const uint8_t* bytes, size_t size)
+        {
+            for (size_t i = 0; i < size; ++i) {
+                hash = (hash ^ bytes[i]) * FnvPrime;
+            }
+        }
+
+        static void hashValue(uint64_t& hash, uint64_t value)
+        {
+            for (int shift = 0; shift < 64; shift += 8) {
+                hash = (hash ^ ((value >> shift) & 0xff)) * FnvPrime;
+            }
+        }
+
+        static std::string makeTempSuffix()
+        {
+            static std::atomic<uint64_t> counter{0};
+            const uint64_t thread_hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+            const uint64_t random = (static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+            char suffix[64];
+            std::snprintf(suffix, sizeof(suffix), ".%016llx%016llx%llx.tmp", 
+                static_cast<unsigned long long>(random), 
+                static_cast<unsigned long long>(thread_hash), 
+                static_cast<unsigned long long>(counter.fetch_add(1, std::memory_order_relaxed))
+            );
+            return suffix;
+        }
+
+        // Write to a temporary file first, so concurrent loaders never map a partially written artifact
+        void store(const std::filesystem::path& cache_path, const wasmtime::component::Component& component) const
+        {
+            auto serialized = component.serialize();
+            if (!serialized) {
+                Core::Logger::warn("Failed to serialize component for cache: {}", serialized.err().message());
+                return;
+            }
+            
+            std::error_code error_code;
+            std::filesystem::create_directories(m_cache_directory, error_code);
+            
+            // Unique per writer, processes or threads missing the same key must never interleave into one file
+            std::filesystem::path temp_path = cache_path;
+            temp_path += makeTempSuffix();
+            {
+                std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+                const std::vector<uint8_t>& bytes = serialized.ok();
+                file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+                if (!file) {
+                    Core::Logger::warn("Failed to write component cache entry {}", temp_path.string());
+                    file.close();
+                    std::filesystem::remove(temp_path, error_code);
+                    return;
+                }
+            }
+            
+            std::filesystem::rename(temp_path, cache_path, error_code);
+            if (error_code) {
+                Core::Logger::warn("Failed to publish component cache entry {}: {}", cache_path.string(), error_code.message());
+                std::filesystem::remove(temp_path, error_code);
+            }
+        }
+
+        std::filesystem::path m_cache_directory;
+    };
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "lib/wasmtime_linker/interface_wasmtime_linker.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace Arieo::Lib::WasmtimeLinker
+{
+    // Functions of a consumer component whose imports are served by a provider component's exports instead of host
+    // code. Built once while linking and shared read-only, like the linker itself; the slot index of a function is
+    // its position in m_functions.
+    struct ComponentForwardingPlan
+    {
+        struct ForwardedFunction
+        {
+            std::string m_interface_name;
+            std::string m_function_name;
+        };
+
+        std::vector<ForwardedFunction> m_functions;
+        std::unordered_set<std::string> m_interface_names;
+    };
+
+    // Provider exports resolved in one store. Component functions can only be called within the store that
+    // instantiated them, so each worker binds its own table after instantiating the provider in its store.
+    class ComponentForwardingTable
+    {
+    public:
+        wasmtime::Result<std::monostate> bind(
+            wasmtime::Store::Context store_ctx,
+            const wasmtime::component::Instance& provider_instance,
+            const ComponentForwardingPlan& forwarding_plan)
+        {
+            m_functions.clear();
+            m_functions.reserve(forwarding_plan.m_functions.size());
+            for (const ComponentForwardingPlan::ForwardedFunction& forwarded_function : forwarding_plan.m_functions) {
+                auto interface_index = provider_instance.get_export_index(store_ctx, nullptr, forwarded_function.m_interface_name);
+                auto function_index = interface_index
+                    ? provider_instance.get_export_index(store_ctx, &*interface_index, forwarded_function.m_function_name)
+                    : std::nullopt;
+                auto func = function_index ? provider_instance.get_func(store_ctx, *function_index) : std::nullopt;
+                if (!func) {
+                    Core::Logger::error("Provider does not export {}.{}", forwarded_function.m_interface_name, forwarded_function.m_function_name);
+                    return wasmtime::Error(
+                        "provider does not export " + forwarded_function.m_interface_name + "." + forwarded_function.m_function_name
+                    );
+                }
+                m_functions.push_back(*func);
+            }
+            return wasmtime::Result<std::monostate>(std::monostate{});
+        }
+
+        const wasmtime::component::Func* find(size_t slot_index) const
+        {
+            return slot_index < m_functions.size() ? &m_functions[slot_index] : nullptr;
+        }
+
+    private:
+        std::vector<wasmtime::component::Func> m_functions;
+    };
+
+    // Table installed for the current thread, with one store per worker this is the store's table
+    inline ComponentForwardingTable*& getThreadComponentForwardingTable()
+    {
+        thread_local ComponentForwardingTable* table = nullptr;
+        return table;
+    }
+
+    // Installs a table for the current thread and restores the previous one on scope exit
+    class ScopedComponentForwardingTable
+    {
+    public:
+        explicit ScopedComponentForwardingTable(ComponentForwardingTable& table)
+            : m_previous(getThreadComponentForwardingTable())
+        {
+            getThreadComponentForwardingTable() = &table;
+        }
+
+        ~ScopedComponentForwardingTable()
+        {
+            getThreadComponentForwardingTable() = m_previous;
+        }
+
+        ScopedComponentForwardingTable(const ScopedComponentForwardingTable&) = delete;
+        ScopedComponentForwardingTable& operator=(const ScopedComponentForwardingTable&) = delete;
+
+    private:
+        ComponentForwardingTable* m_previous;
+    };
+
+    // Wire every consumer import the provider component exports straight to the provider. wasmtime still lifts the
+    // consumer's arguments into component::Val and lowers them into the provider, and the results take the same
+    // path back. What is skipped is the C++ side: the Vals are handed to the provider's export as they arrive and
+    // its results are written back in place, never decoded into C++ values or re-encoded in between.
+    // Imports the provider does not export fall through to the host export info as usual.
+    inline wasmtime::Result<std::monostate> defineComponentImportsWithProvider(
+        const wasmtime::Engine& engine,
+        wasmtime::component::Linker& linker,
+        const wasmtime::component::Component& consumer_component,
+        const wasmtime::component::Component& provider_component,
+        const LinkerExportInfo& linker_export_info,
+        ComponentForwardingPlan& forwarding_plan)
+    {
+        const auto consumer_type = consumer_component.type();
+        const auto provider_type = provider_component.type();
+        const size_t import_count = consumer_type.import_count(engine);
+        for (size_t i = 0; i < import_count; ++i) {
+            auto import_item = consumer_type.import_nth(engine, i);
+            if (!import_item || !import_item->second.is_component_instance()) {
+                continue;
+            }
+
+            auto export_item = provider_type.export_get(engine, import_item->first);
+            if (!export_item || !export_item->is_component_instance()) {
+                continue;
+            }
+
+            const std::string interface_name(import_item->first);
+            auto linker_instance = linker.root().add_instance(interface_name);
+            if (!linker_instance) {
+                Core::Logger::error("Failed to add linker instance {}", interface_name);
+                return wasmtime::Error("failed to add linker instance " + interface_name);
+            }
+
+            const auto import_type = import_item->second.component_instance();
+            const auto export_type = export_item->component_instance();
+            const size_t function_count = import_type.export_count(engine);
+            for (size_t j = 0; j < function_count; ++j) {
+                auto function_item = import_type.export_nth(engine, j);
+                if (!function_item || !function_item->second.is_component_func()) {
+                    continue;
+                }
+
+                const std::string function_name(function_item->first);
+                auto provided_item = export_type.export_get(engine, function_name);
+                if (!provided_item || !provided_item->is_component_func()) {
+                    Core::Logger::error("Provider of {} does not export {}", interface_name, function_name);
+                    return wasmtime::Error("provider of " + interface_name + " does not export " + function_name);
+                }
+
+                // wasmtime type-checks the Vals on every call, this only rejects arity mismatches early
+                const auto import_func_type = function_item->second.component_func();
+                const auto export_func_type = provided_item->component_func();
+                if (import_func_type.param_count() != export_func_type.param_count() ||
+                    import_func_type.result_count() != export_func_type.result_count()) {
+                    Core::Logger::error("Signature mismatch between import and provider export {}.{}", interface_name, function_name);
+                    return wasmtime::Error("signature mismatch for forwarded " + interface_name + "." + function_name);
+                }
+
+                const size_t slot_index = forwarding_plan.m_functions.size();
+                auto result = linker_instance.ok().add_func(function_name,
+                    [slot_index](
+                        wasmtime::Store::Context store_ctx,
+                        const wasmtime::component::FuncType&,
+                        wasmtime::Span<wasmtime::component::Val> args,
+                        wasmtime::Span<wasmtime::component::Val> results) -> wasmtime::Result<std::monostate>
+                    {
+                        const ComponentForwardingTable* table = getThreadComponentForwardingTable();
+                        const wasmtime::component::Func* func = table ? table->find(slot_index) : nullptr;
+                        if (!func) {
+                            return wasmtime::Error("forwarded function called without a bound ComponentForwardingTable");
+                        }
+
+                        auto call_result = func->call(store_ctx, args, results);
+                        if (!call_result) {
+                            return call_result;
+                        }
+                        return func->post_return(store_ctx);
+                    }
+                );
+                if (!result) {
+                    Core::Logger::error("Failed to define forwarded function {}.{}", interface_name, function_name);
+                    return result;
+                }
+                forwarding_plan.m_functions.push_back(ComponentForwardingPlan::ForwardedFunction{interface_name, function_name});
+            }
+            forwarding_plan.m_interface_names.insert(interface_name);
+        }
+
+        // Host exports for everything the provider does not cover
+        std::vector<InterfaceExportInfo> host_interfaces;
+        host_interfaces.reserve(linker_export_info.m_interface_count);
+        for (size_t i = 0; i < linker_export_info.m_interface_count; ++i) {
+            if (!forwarding_plan.m_interface_names.contains(linker_export_info.m_interface_array[i].m_interface_name)) {
+                host_interfaces.push_back(linker_export_info.m_interface_array[i]);
+            }
+        }
+        return defineImportedComponentExports(
+            engine, linker, consumer_component, LinkerExportInfo{host_interfaces.data(), host_interfaces.size()}
+        );
+    }
+}
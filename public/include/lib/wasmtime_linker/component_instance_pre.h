@@ -0,0 +1,73 @@
+#pragma once
+
+#include "lib/wasmtime_linker/interface_wasmtime_linker.h"
+
+namespace Arieo::Lib::WasmtimeLinker 
+{
+    // Sizing of wasmtime's pooling instance allocator. Slots are reserved up front when the Engine is created,
+    // so instantiation only claims a slot and maps copy-on-write memory instead of allocating.
+    struct PoolingAllocatorOptions
+    {
+        uint32_t m_total_component_instances = 1000;
+        uint32_t m_total_core_instances = 1000;
+        uint32_t m_total_memories = 1000;
+        uint32_t m_total_tables = 1000;
+        uint32_t m_total_stacks = 1000;
+        size_t m_max_memory_size = size_t(64) << 20;
+        bool m_memory_init_cow = true;
+    };
+
+    // Apply the pooling allocator to a Config before the Engine shared by all ComponentInstancePre is created
+    inline void configurePoolingAllocator(wasmtime::Config& config, const PoolingAllocatorOptions& options)
+    {
+        wasmtime::PoolAllocationConfig pool_config;
+        pool_config.total_component_instances(options.m_total_component_instances);
+        pool_config.total_core_instances(options.m_total_core_instances);
+        pool_config.total_memories(options.m_total_memories);
+        pool_config.total_tables(options.m_total_tables);
+        pool_config.total_stacks(options.m_total_stacks);
+        pool_config.max_memory_size(options.m_max_memory_size);
+        
+        config.pooling_allocation_strategy(pool_config);
+        config.memory_init_cow(options.m_memory_init_cow);
+    }
+
+    // A component paired with a linker on which the host functions it imports were defined, and validated, exactly once.
+    // Instantiating per task then skips every define call and only resolves imports into a fresh store.
+    class ComponentInstancePre
+    {
+    public:
+        static wasmtime::Result<ComponentInstancePre> create(
+            wasmtime::Engine& engine,
+            wasmtime::component::Component component,
+            const LinkerExportInfo& linker_export_info)
+        {
+            ComponentInstancePre instance_pre(engine, std::move(component));
+            auto result = defineImportedComponentExports(engine, instance_pre.m_linker, instance_pre.m_component, linker_export_info);
+            if (!result) {
+                return result.err();
+            }
+            return instance_pre;
+        }
+
+        // Safe to call concurrently for different stores, instantiation only reads the linker definitions
+        wasmtime::Result<wasmtime::component::Instance> instantiate(wasmtime::Store::Context store_ctx) const
+        {
+            return m_linker.instantiate(store_ctx, m_component);
+        }
+
+        const wasmtime::component::Component& getComponent() const { return m_component; }
+        const wasmtime::component::Linker& getLinker() const { return m_linker; }
+
+    private:
+        ComponentInstancePre(wasmtime::Engine& engine, wasmtime::component::Component component)
+            : m_linker(engine)
+            , m_component(std::move(component))
+        {
+        }
+
+        // Mutable only because the wasmtime wrapper's instantiate is non-const, definitions never change after create()
+        mutable wasmtime::component::Linker m_linker;
+        wasmtime::component::Component m_component;
+    };
+}
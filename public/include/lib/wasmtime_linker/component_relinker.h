@@ -0,0 +1,333 @@
+#pragma once
+
+#include "lib/wasmtime_linker/interface_wasmtime_linker.h"
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace Arieo::Lib::WasmtimeLinker
+{
+    struct RelinkStats
+    {
+        size_t m_kept_count = 0;        // Checksum unchanged, only the callback pointers were refreshed
+        size_t m_updated_count = 0;     // Checksum changed or provided again, revalidated against the import and swapped in place
+        size_t m_defined_count = 0;     // Newly defined on the linker
+        size_t m_removed_count = 0;     // No longer exported, calls now trap
+        size_t m_unbound_count = 0;     // Newly defined on the linker without a provider yet, calls trap
+    };
+
+    // A component linker whose host functions can be swapped when a plugin DLL is reloaded, without rebuilding the
+    // linker or re-instantiating the component.
+    // Each imported function is defined once on the linker as a thunk that reads a host-owned slot. The first relink()
+    // to see an interface defines its linker instance with a slot for every function the component imports from it,
+    // a provider or not, because an instance can only be added to the linker once. Later relink() calls diff the new
+    // LinkerExportInfo against the slots by m_interface_checksum/m_function_checksum: every slot picks up the new
+    // DLL's callback pointers, only changed functions are revalidated, only interfaces seen for the first time reach
+    // the linker. Imports no plugin provides trap when called instead of failing instantiation.
+    // relink() must not run while any store instantiated from this linker executes guest code, and the relinker
+    // must outlive those instances.
+    class ComponentRelinker
+    {
+    public:
+        ComponentRelinker(wasmtime::Engine& engine, wasmtime::component::Component component)
+            : m_engine(engine)
+            , m_linker(engine)
+            , m_component(std::move(component))
+        {
+        }
+
+        ComponentRelinker(const ComponentRelinker&) = delete;
+        ComponentRelinker& operator=(const ComponentRelinker&) = delete;
+
+        // The first call links every interface the component imports, later calls apply the diff.
+        // New functions are validated while being defined; a definition failure midway is unrecoverable and calls
+        // for a fresh relinker.
+        wasmtime::Result<RelinkStats> relink(const LinkerExportInfo& linker_export_info)
+        {
+            // Reject an incompatible reload before any slot is touched, so a failed relink leaves the previous plugin linked
+            auto validate_result = validateChangedFunctions(linker_export_info);
+            if (!validate_result) {
+                return validate_result.err();
+            }
+
+            RelinkStats stats;
+            ++m_generation;
+
+            for (size_t i = 0; i < linker_export_info.m_interface_count; ++i) {
+                const InterfaceExportInfo& interface_info = linker_export_info.m_interface_array[i];
+
+                if (!m_linked_interfaces.contains(interface_info.m_interface_name)) {
+                    auto result = linkInterface(interface_info, stats);
+                    if (!result) {
+                        return result.err();
+                    }
+                    continue;
+                }
+
+                auto previous_checksum = m_interface_checksums.find(interface_info.m_interaface_id);
+                const bool interface_unchanged =
+                    previous_checksum != m_interface_checksums.end() && previous_checksum->second == interface_info.m_interface_checksum;
+                m_interface_checksums[interface_info.m_interaface_id] = interface_info.m_interface_checksum;
+
+                for (size_t j = 0; j < interface_info.m_member_function_count; ++j) {
+                    const InterfaceFunctionExportInfo& function_info = interface_info.m_member_function_array[j];
+                    for (bool is_batch : {false, true}) {
+                        rebindFunction(interface_info, function_info, is_batch, interface_unchanged, stats);
+                    }
+                }
+            }
+
+            // Slots the new export info did not visit belong to functions the plugin no longer provides
+            for (auto& [key, slot] : m_slots) {
+                if (slot->m_generation != m_generation && !isUnbound(*slot)) {
+                    unbindSlot(*slot);
+                    ++stats.m_removed_count;
+                }
+            }
+
+            Core::Logger::info("Relinked component: kept={}, updated={}, defined={}, removed={}, unbound={}",
+                stats.m_kept_count, stats.m_updated_count, stats.m_defined_count, stats.m_removed_count, stats.m_unbound_count
+            );
+            return stats;
+        }
+
+        wasmtime::Result<wasmtime::component::Instance> instantiate(wasmtime::Store::Context store_ctx)
+        {
+            return m_linker.instantiate(store_ctx, m_component);
+        }
+
+        const wasmtime::component::Component& getComponent() const { return m_component; }
+
+    private:
+        struct FunctionSlot
+        {
+            InterfaceFunctionHostCallback m_callback;
+            InterfaceFunctionCallStats* m_call_stats = nullptr;
+            uint64_t m_function_checksum = 0;
+            uint64_t m_generation = 0;
+            InterfaceFunctionAffinity m_affinity = InterfaceFunctionAffinity::Any;
+            std::string m_interface_name;   // Owned copies for profiler zones, the export info dies with its DLL
+            std::string m_function_name;
+        };
+
+        // (interface name, imported function name), batch variants carry their suffix. Names rather than ids,
+        // because slots exist for imports no loaded plugin provides.
+        using SlotKey = std::pair<std::string, std::string>;
+
+        static wasmtime::Result<std::monostate> slotTrampoline(
+            const void* context,
+            wasmtime::Store::Context store_ctx,
+            const wasmtime::component::FuncType& func_type,
+            wasmtime::Span<wasmtime::component::Val> args,
+            wasmtime::Span<wasmtime::component::Val> results)
+        {
+            const FunctionSlot* slot = static_cast<const FunctionSlot*>(context);
+            ScopedProfilerZone profiler_zone(slot->m_interface_name, slot->m_function_name);
+            ScopedCallStatsTimer call_stats_timer(slot->m_call_stats);
+            ScopedHostCallAffinity affinity_scope(slot->m_affinity);
+            return slot->m_callback(store_ctx, func_type, args, results);
+        }
+
+        static wasmtime::Result<std::monostate> unboundTrampoline(
+            const void*,
+            wasmtime::Store::Context,
+            const wasmtime::component::FuncType&,
+            wasmtime::Span<wasmtime::component::Val>,
+            wasmtime::Span<wasmtime::component::Val>)
+        {
+            return wasmtime::Error("host function is not provided by any loaded plugin");
+        }
+
+        static bool isUnbound(const FunctionSlot& slot)
+        {
+            return slot.m_callback.getTrampoline() == &unboundTrampoline;
+        }
+
+        static void unbindSlot(FunctionSlot& slot)
+        {
+            slot.m_callback = InterfaceFunctionHostCallback(&unboundTrampoline);
+            slot.m_call_stats = nullptr;
+            slot.m_function_checksum = 0;
+            slot.m_affinity = InterfaceFunctionAffinity::Any;
+        }
+
+        static SlotKey makeSlotKey(const InterfaceExportInfo& interface_info, const InterfaceFunctionExportInfo& function_info, bool is_batch)
+        {
+            return SlotKey{
+                interface_info.m_interface_name, 
+                std::string(function_info.m_function_name) + (is_batch ? std::string(BatchFunctionSuffix) : std::string())
+            };
+        }
+
+        static void bindSlot(
+            FunctionSlot& slot, 
+            const InterfaceExportInfo& interface_info, 
+            const InterfaceFunctionExportInfo& function_info, 
+            bool is_batch, 
+            uint64_t generation)
+        {
+            // The reloaded DLL's code and tables live at new addresses even when nothing changed
+            slot.m_callback = is_batch ? function_info.m_batch_host_callback : function_info.m_host_callback;
+            slot.m_call_stats = function_info.m_call_stats;
+            slot.m_function_checksum = function_info.m_function_checksum;
+            slot.m_generation = generation;
+            slot.m_affinity = function_info.m_affinity;
+            slot.m_interface_name = interface_info.m_interface_name;
+            slot.m_function_name = function_info.m_function_name;
+        }
+
+        // Add the interface's linker instance once and define a thunk for every function the component imports from it
+        wasmtime::Result<std::monostate> linkInterface(const InterfaceExportInfo& interface_info, RelinkStats& stats)
+        {
+            auto import_item = m_component.type().import_get(m_engine, interface_info.m_interface_name);
+            if (!import_item || !import_item->is_component_instance()) {
+                return wasmtime::Result<std::monostate>(std::monostate{});
+            }
+
+            auto linker_instance = m_linker.root().add_instance(interface_info.m_interface_name);
+            if (!linker_instance) {
+                Core::Logger::error("Failed to add linker instance {}", interface_info.m_interface_name);
+                return wasmtime::Error(std::string("failed to add linker instance ") + interface_info.m_interface_name);
+            }
+            m_linked_interfaces.insert(interface_info.m_interface_name);
+            m_interface_checksums[interface_info.m_interaface_id] = interface_info.m_interface_checksum;
+
+            const auto instance_type = import_item->component_instance();
+            const size_t function_count = instance_type.export_count(m_engine);
+            for (size_t j = 0; j < function_count; ++j) {
+                auto function_item = instance_type.export_nth(m_engine, j);
+                if (!function_item || !function_item->second.is_component_func()) {
+                    continue;
+                }
+
+                // Same matching as defineImportedComponentExports, a member's own name wins over a batch variant
+                const std::string function_name(function_item->first);
+                const InterfaceFunctionExportInfo* function_info = findMember(interface_info, function_name);
+                const bool is_batch = !function_info && function_name.ends_with(BatchFunctionSuffix);
+                if (is_batch) {
+                    function_info = findMember(interface_info, std::string_view(function_name).substr(0, function_name.size() - BatchFunctionSuffix.size()));
+                }
+
+                auto slot = std::make_unique<FunctionSlot>();
+                if (function_info) {
+                    // Validation and error reporting match the eager path. Stats, zones and affinity are applied by
+                    // the slot, so the thunk never refers to the export info of the DLL it was first linked against.
+                    const auto func_type = function_item->second.component_func();
+                    auto result = validateComponentFunction(interface_info, *function_info, function_name, func_type, is_batch);
+                    if (!result) {
+                        return result;
+                    }
+                    bindSlot(*slot, interface_info, *function_info, is_batch, m_generation);
+                } else {
+                    unbindSlot(*slot);
+                    slot->m_interface_name = interface_info.m_interface_name;
+                    slot->m_function_name = function_name;
+                    slot->m_generation = m_generation;
+                }
+
+                auto result = addComponentLinkerCallback(
+                    linker_instance.ok(), interface_info, function_name, InterfaceFunctionAffinity::Any, InterfaceFunctionHostCallback(&slotTrampoline, slot.get())
+                );
+                if (!result) {
+                    return result;
+                }
+
+                ++(function_info ? stats.m_defined_count : stats.m_unbound_count);
+                m_slots.emplace(SlotKey{interface_info.m_interface_name, function_name}, std::move(slot));
+            }
+            return wasmtime::Result<std::monostate>(std::monostate{});
+        }
+
+        static const InterfaceFunctionExportInfo* findMember(const InterfaceExportInfo& interface_info, std::string_view member_name)
+        {
+            for (size_t k = 0; k < interface_info.m_member_function_count; ++k) {
+                if (member_name == interface_info.m_member_function_array[k].m_function_name) {
+                    return &interface_info.m_member_function_array[k];
+                }
+            }
+            return nullptr;
+        }
+
+        // Every import of a linked interface has a slot, so a member without one is simply not imported
+        void rebindFunction(
+            const InterfaceExportInfo& interface_info,
+            const InterfaceFunctionExportInfo& function_info,
+            bool is_batch,
+            bool interface_unchanged,
+            RelinkStats& stats)
+        {
+            auto found_slot = m_slots.find(makeSlotKey(interface_info, function_info, is_batch));
+            if (found_slot == m_slots.end()) {
+                return;
+            }
+
+            FunctionSlot& slot = *found_slot->second;
+            if (isUnbound(slot) || (!interface_unchanged && slot.m_function_checksum != function_info.m_function_checksum)) {
+                ++stats.m_updated_count;
+            } else {
+                ++stats.m_kept_count;
+            }
+            bindSlot(slot, interface_info, function_info, is_batch, m_generation);
+        }
+
+        // A changed or newly provided function keeps its linker definition, so its C++ signature must still match
+        // the import
+        wasmtime::Result<std::monostate> validateChangedFunctions(const LinkerExportInfo& linker_export_info)
+        {
+            for (size_t i = 0; i < linker_export_info.m_interface_count; ++i) {
+                const InterfaceExportInfo& interface_info = linker_export_info.m_interface_array[i];
+                auto previous_checksum = m_interface_checksums.find(interface_info.m_interaface_id);
+                if (previous_checksum != m_interface_checksums.end() && previous_checksum->second == interface_info.m_interface_checksum) {
+                    continue;
+                }
+
+                for (size_t j = 0; j < interface_info.m_member_function_count; ++j) {
+                    const InterfaceFunctionExportInfo& function_info = interface_info.m_member_function_array[j];
+                    for (bool is_batch : {false, true}) {
+                        auto found_slot = m_slots.find(makeSlotKey(interface_info, function_info, is_batch));
+                        if (found_slot == m_slots.end() ||
+                            (!isUnbound(*found_slot->second) && found_slot->second->m_function_checksum == function_info.m_function_checksum)) {
+                            continue;
+                        }
+
+                        auto result = validateImport(interface_info, function_info, is_batch);
+                        if (!result) {
+                            return result;
+                        }
+                    }
+                }
+            }
+            return wasmtime::Result<std::monostate>(std::monostate{});
+        }
+
+        wasmtime::Result<std::monostate> validateImport(
+            const InterfaceExportInfo& interface_info,
+            const InterfaceFunctionExportInfo& function_info,
+            bool is_batch)
+        {
+            std::string function_name = std::string(function_info.m_function_name) + (is_batch ? std::string(BatchFunctionSuffix) : std::string());
+            auto func_type = findImportedFuncType(m_engine, m_component, interface_info.m_interface_name, function_name);
+            const InterfaceFunctionSignatureValidator validator =
+                is_batch ? function_info.m_batch_signature_validator : function_info.m_signature_validator;
+            if (func_type && !validator(*func_type)) {
+                Core::Logger::error("Signature mismatch for {}.{} after reload", interface_info.m_interface_name, function_name);
+                return wasmtime::Error(
+                    std::string("signature mismatch after reload for ") + interface_info.m_interface_name + "." + function_name
+                );
+            }
+            return wasmtime::Result<std::monostate>(std::monostate{});
+        }
+
+        wasmtime::Engine& m_engine;
+        wasmtime::component::Linker m_linker;
+        wasmtime::component::Component m_component;
+        std::map<SlotKey, std::unique_ptr<FunctionSlot>> m_slots;
+        std::map<uint64_t, uint64_t> m_interface_checksums;
+        std::set<std::string, std::less<>> m_linked_interfaces;
+        uint64_t m_generation = 0;
+    };
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "lib/wasmtime_linker/component_forwarding.h"
+#include "lib/wasmtime_linker/component_instance_pre.h"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+namespace Arieo::Lib::WasmtimeLinker 
+{
+    // Execution model for running guests on every worker of a job system:
+    //  - One wasmtime::Engine per process, shared by all threads. Engines are internally synchronized.
+    //  - One ComponentInstancePre per component, built once from the LinkerExportInfo and never modified
+    //    afterwards, shared read-only by all threads.
+    //  - One wasmtime::Store per worker, only ever used by the thread running that worker. The
+    //    Store::Context handed to an InterfaceFunctionHostCallback always belongs to the calling worker.
+    //  - Export tables are immutable after generateLinkerExportInfo and generated callbacks hold no mutable
+    //    state, so callbacks on different stores run in parallel without locks. Host objects reached through
+    //    the instance argument must do their own synchronization if several workers share them.
+    //  - One InterfaceScratchArena per worker for call temporaries. Install it with ScopedInterfaceScratchArena
+    //    while the worker's thread runs guest code, otherwise a thread-local arena is used.
+    //  - One ComponentForwardingTable per worker when script-to-script imports are forwarded, bound to the provider
+    //    instance in the worker's store and installed with ScopedComponentForwardingTable the same way.
+    //  - Functions tagged MainThread through InterfaceThreadAffinity are handed to the MainThreadDispatchQueue.
+    //    The main thread binds the queue once and drains it every frame while workers run guests.
+    class ComponentWorker
+    {
+    public:
+        ComponentWorker(wasmtime::Engine& engine, std::shared_ptr<const ComponentInstancePre> instance_pre)
+            : m_store(engine)
+            , m_instance_pre(std::move(instance_pre))
+        {
+        }
+
+        // Instantiate into this worker's store, call only from the thread that owns the worker
+        wasmtime::Result<wasmtime::component::Instance> instantiate()
+        {
+            return m_instance_pre->instantiate(m_store.context());
+        }
+
+        wasmtime::Store::Context getStoreContext() { return m_store.context(); }
+        InterfaceScratchArena& getScratchArena() { return m_scratch_arena; }
+        ComponentForwardingTable& getForwardingTable() { return m_forwarding_table; }
+
+    private:
+        wasmtime::Store m_store;
+        InterfaceScratchArena m_scratch_arena;
+        ComponentForwardingTable m_forwarding_table;
+        std::shared_ptr<const ComponentInstancePre> m_instance_pre;
+    };
+
+    // Fixed set of workers indexed by job system worker index, the lookup is a plain array access because
+    // every index is only ever used by its own thread
+    class ComponentWorkerPool
+    {
+    public:
+        // hardware_concurrency() reports 0 when it is unknown, the default still creates one worker
+        ComponentWorkerPool(
+            wasmtime::Engine& engine, 
+            std::shared_ptr<const ComponentInstancePre> instance_pre, 
+            size_t worker_count = std::max<size_t>(1, std::thread::hardware_concurrency()))
+        {
+            m_workers.reserve(worker_count);
+            for (size_t i = 0; i < worker_count; ++i) {
+                m_workers.emplace_back(std::make_unique<ComponentWorker>(engine, instance_pre));
+            }
+        }
+
+        ComponentWorker& getWorker(size_t worker_index) { return *m_workers[worker_index]; }
+        size_t getWorkerCount() const { return m_workers.size(); }
+
+    private:
+        std::vector<std::unique_ptr<ComponentWorker>> m_workers;
+    };
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "lib/wasmtime_linker/interface_wasmtime_linker.h"
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+namespace Arieo::Lib::WasmtimeLinker
+{
+    // Single-producer single-consumer command ring a core wasm guest allocates in its linear memory, 64-byte aligned:
+    //   [0]    u32 capacity        power-of-two size of the data area in bytes, written once before the first command
+    //   [4]    u32 write_offset    free-running byte counter, only advanced by the guest once a command is complete
+    //   [64]   u32 read_offset     free-running byte counter, only advanced by the host
+    //   [128]  data[capacity]
+    // A command is an 8-byte aligned record { u32 size; u32 function_index; payload } where size covers header,
+    // payload and padding, function_index addresses the interface's m_member_function_array (sorted by function id)
+    // and the payload follows commandPayloadLayout. A record never wraps: when it does not fit before the end of the
+    // data area the guest fills the rest with a padding record of function_index PaddingIndex and starts over.
+    struct GuestCommandRingLayout
+    {
+        static constexpr uint32_t CapacityOffset = 0;
+        static constexpr uint32_t WriteOffset = 4;
+        static constexpr uint32_t ReadOffset = 64;
+        static constexpr uint32_t DataOffset = 128;
+        static constexpr uint32_t RingAlignment = 64;
+        static constexpr uint32_t RecordAlignment = 8;
+        static constexpr uint32_t RecordHeaderSize = 8;
+        static constexpr uint32_t PaddingIndex = 0xFFFFFFFFu;
+    };
+
+    struct CommandRingDrainResult
+    {
+        size_t m_dispatched_count = 0;
+        size_t m_failed_count = 0;      // Unknown function index, non-queueable function or unresolved instance
+        bool m_out_of_fuel = false;     // Draining stopped at a command the store could not pay for
+    };
+
+    // Every command is one host call: it is timed into the function's call stats and, when a store is given, charged
+    // the host call fuel cost before it runs. A command the store cannot pay for stays in the ring.
+    inline wasmtime::Result<CommandRingDrainResult> drainGuestCommandRingImpl(
+        wasmtime::Store::Context* fuel_store_ctx,
+        wasmtime::Span<uint8_t> memory,
+        uint32_t ring_offset,
+        const InterfaceExportInfo& interface_info,
+        size_t max_commands)
+    {
+        using Layout = GuestCommandRingLayout;
+        if (ring_offset % Layout::RingAlignment != 0 || ring_offset > memory.size() || memory.size() - ring_offset < Layout::DataOffset) {
+            return wasmtime::Error("command ring is misaligned or outside guest memory");
+        }
+
+        uint8_t* ring = memory.data() + ring_offset;
+        const uint32_t capacity = readGuestField<uint32_t>(reinterpret_cast<const std::byte*>(ring + Layout::CapacityOffset));
+        if (capacity < Layout::RecordHeaderSize || !std::has_single_bit(capacity) || memory.size() - ring_offset - Layout::DataOffset < capacity) {
+            return wasmtime::Error("command ring capacity is invalid");
+        }
+
+        std::atomic_ref<uint32_t> write_ref(*reinterpret_cast<uint32_t*>(ring + Layout::WriteOffset));
+        std::atomic_ref<uint32_t> read_ref(*reinterpret_cast<uint32_t*>(ring + Layout::ReadOffset));
+        const uint32_t write_offset = write_ref.load(std::memory_order_acquire);
+        uint32_t read_offset = read_ref.load(std::memory_order_relaxed);
+        if (write_offset - read_offset > capacity) {
+            return wasmtime::Error("command ring overrun");
+        }
+
+        CommandRingDrainResult result;
+        const std::byte* data = reinterpret_cast<const std::byte*>(ring + Layout::DataOffset);
+        while (read_offset != write_offset && result.m_dispatched_count + result.m_failed_count < max_commands) {
+            const uint32_t position = read_offset & (capacity - 1);
+            const uint32_t record_size = readGuestField<uint32_t>(data + position);
+            const uint32_t function_index = readGuestField<uint32_t>(data + position + 4);
+            if (record_size < Layout::RecordHeaderSize || record_size % Layout::RecordAlignment != 0 ||
+                record_size > capacity - position || record_size > write_offset - read_offset) {
+                read_ref.store(read_offset, std::memory_order_release);
+                return wasmtime::Error("corrupt command ring record");
+            }
+
+            if (function_index != Layout::PaddingIndex) {
+                if (fuel_store_ctx && !chargeHostCallFuel(*fuel_store_ctx)) {
+                    result.m_out_of_fuel = true;
+                    break;
+                }
+
+                const InterfaceFunctionExportInfo* function_info =
+                    function_index < interface_info.m_member_function_count ? &interface_info.m_member_function_array[function_index] : nullptr;
+                bool dispatched = false;
+                if (function_info && function_info->m_command_decoder) {
+                    ScopedProfilerZone profiler_zone(interface_info.m_interface_name, function_info->m_function_name);
+                    ScopedCallStatsTimer call_stats_timer(function_info->m_call_stats);
+                    ScopedHostCallAffinity affinity_scope(function_info->m_affinity);
+                    dispatched = function_info->m_command_decoder(
+                        function_info->m_host_callback.getContext(), data + position + Layout::RecordHeaderSize, record_size - Layout::RecordHeaderSize
+                    );
+                }
+                if (dispatched) {
+                    ++result.m_dispatched_count;
+                } else {
+                    ++result.m_failed_count;
+                }
+            }
+            read_offset += record_size;
+        }
+        read_ref.store(read_offset, std::memory_order_release);
+
+        if (result.m_failed_count != 0) {
+            static DiagnosticRateLimiter rate_limiter;
+            if (rate_limiter.shouldLog()) {
+                Core::Logger::error("Dropped {} commands for {} ({} occurrences)", result.m_failed_count, interface_info.m_interface_name, rate_limiter.getCount());
+            }
+        }
+        return result;
+    }
+
+    // Dispatch the complete commands of one ring through the generated command decoders, in order. Only one thread
+    // may drain a given ring and the guest must not grow its memory meanwhile, so drain on the store's thread between
+    // guest calls or from the flush host function. A structurally corrupt ring is an error, which the caller should
+    // treat as a guest fault; the read offset is left where the corruption starts.
+    inline wasmtime::Result<CommandRingDrainResult> drainGuestCommandRing(
+        wasmtime::Span<uint8_t> memory,
+        uint32_t ring_offset,
+        const InterfaceExportInfo& interface_info,
+        size_t max_commands = std::numeric_limits<size_t>::max())
+    {
+        return drainGuestCommandRingImpl(nullptr, memory, ring_offset, interface_info, max_commands);
+    }
+
+    // Same, charging the host call fuel cost of every command to store_ctx as if the guest had called it directly
+    inline wasmtime::Result<CommandRingDrainResult> drainGuestCommandRing(
+        wasmtime::Store::Context store_ctx,
+        wasmtime::Span<uint8_t> memory,
+        uint32_t ring_offset,
+        const InterfaceExportInfo& interface_info,
+        size_t max_commands = std::numeric_limits<size_t>::max())
+    {
+        return drainGuestCommandRingImpl(&store_ctx, memory, ring_offset, interface_info, max_commands);
+    }
+
+    // Module and function under which defineCommandRingExports provides flush(interface_id: i64, ring: i32) -> i32
+    inline constexpr std::string_view CommandRingModuleName = "arieo:command-ring";
+    inline constexpr std::string_view CommandRingFlushFunctionName = "flush";
+
+    // Let core wasm guests flush a ring in one host transition, however many commands it holds. The ring itself
+    // carries all state, so one definition serves every ring and store. Returns the number of dispatched commands.
+    // Each command is charged like a direct host call, a flush the store cannot pay for in full traps.
+    inline wasmtime::Result<std::monostate> defineCommandRingExports(wasmtime::Linker& linker, const LinkerExportInfo& linker_export_info)
+    {
+        const LinkerExportInfo* export_info = &linker_export_info;
+        auto result = linker.func_wrap(CommandRingModuleName, CommandRingFlushFunctionName,
+            [export_info](wasmtime::Caller caller, int64_t interface_id, int32_t ring_offset) -> wasmtime::Result<int32_t, wasmtime::Trap> {
+                const InterfaceExportInfo* interface_info = findInterfaceExportInfo(*export_info, static_cast<uint64_t>(interface_id));
+                if (!interface_info) {
+                    return wasmtime::Trap("command ring flushed for an unknown interface");
+                }
+
+                auto memory_export = caller.get_export("memory");
+                if (!memory_export || !std::holds_alternative<wasmtime::Memory>(*memory_export)) {
+                    return wasmtime::Trap("Guest does not export memory");
+                }
+
+                auto drain_result = drainGuestCommandRing(
+                    caller.context(), std::get<wasmtime::Memory>(*memory_export).data(caller.context()), static_cast<uint32_t>(ring_offset), *interface_info
+                );
+                if (!drain_result) {
+                    return wasmtime::Trap(drain_result.err().message());
+                }
+                if (drain_result.ok().m_out_of_fuel) {
+                    return wasmtime::Trap("all fuel consumed by host calls");
+                }
+                return static_cast<int32_t>(drain_result.ok().m_dispatched_count);
+            }
+        );
+        if (!result) {
+            Core::Logger::error("Failed to define {}.{}", CommandRingModuleName, CommandRingFlushFunctionName);
+        }
+        return result;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+namespace Arieo::Lib::WasmtimeLinker 
+{
+    // Per-function call counters, updated with relaxed atomics by the callbacks defined in a linker.
+    // Recording is compiled in with ARIEO_WASMTIME_LINKER_CALL_STATS, otherwise the counters stay zero.
+    struct InterfaceFunctionCallStats
+    {
+        // Bucket i counts calls that took [2^(i-1), 2^i) nanoseconds, the last bucket also holds everything slower
+        static constexpr std::size_t HistogramBucketCount = 32;
+
+        std::atomic<uint64_t> m_call_count{0};
+        std::atomic<uint64_t> m_total_nanoseconds{0};
+        std::array<std::atomic<uint64_t>, HistogramBucketCount> m_latency_histogram{};
+
+        static constexpr std::size_t getBucketIndex(uint64_t nanoseconds)
+        {
+            const std::size_t bucket = static_cast<std::size_t>(std::bit_width(nanoseconds));
+            return bucket < HistogramBucketCount ? bucket : HistogramBucketCount - 1;
+        }
+
+        void record(uint64_t nanoseconds)
+        {
+            m_call_count.fetch_add(1, std::memory_order_relaxed);
+            m_total_nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+            m_latency_histogram[getBucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void reset()
+        {
+            m_call_count.store(0, std::memory_order_relaxed);
+            m_total_nanoseconds.store(0, std::memory_order_relaxed);
+            for (std::atomic<uint64_t>& bucket : m_latency_histogram) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // Times one host call into the given stats, a no-op for null stats or when call stats are compiled out
+    class ScopedCallStatsTimer
+    {
+    public:
+#if defined(ARIEO_WASMTIME_LINKER_CALL_STATS)
+        explicit ScopedCallStatsTimer(InterfaceFunctionCallStats* call_stats)
+            : m_call_stats(call_stats)
+            , m_start(call_stats ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{})
+        {
+        }
+
+        ~ScopedCallStatsTimer()
+        {
+            if (m_call_stats) {
+                const auto elapsed = std::chrono::steady_clock::now() - m_start;
+                m_call_stats->record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            }
+        }
+
+    private:
+        InterfaceFunctionCallStats* m_call_stats;
+        std::chrono::steady_clock::time_point m_start;
+#else
+        explicit ScopedCallStatsTimer(InterfaceFunctionCallStats*) {}
+#endif
+    public:
+        ScopedCallStatsTimer(const ScopedCallStatsTimer&) = delete;
+        ScopedCallStatsTimer& operator=(const ScopedCallStatsTimer&) = delete;
+    };
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include "core/module/module.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Arieo::Lib::WasmtimeLinker 
+{
+    // Generation-indexed slot array mapping compact 32-bit guest handles to host instances.
+    // A handle packs the slot index in the low bits and the slot generation in the high bits, so a stale
+    // handle to a reused slot resolves to null. Slot 0 is never handed out, handle 0 is always invalid.
+    // Freed slots are reused oldest first, and a slot whose generation would wrap is retired instead of freed, so
+    // no generation of a slot is ever handed out twice and a stale handle can never match a later occupant.
+    // Slots are allocated in chunks as the table grows, capacity only bounds the number of live handles.
+    // insert/remove are serialized internally. resolve is lock-free and may race with them: a handle being removed
+    // resolves to its instance or to null, never to the next occupant of its slot. Keeping a resolved instance
+    // alive while it is used remains up to the owner.
+    class InterfaceHandleTable
+    {
+    public:
+        static constexpr uint32_t IndexBits = 20;
+        static constexpr uint32_t IndexMask = (1u << IndexBits) - 1;
+        static constexpr uint32_t MaxCapacity = 1u << IndexBits;
+        static constexpr uint32_t MaxGeneration = (1u << (32 - IndexBits)) - 1;
+        static constexpr uint32_t DefaultCapacity = 1u << 16;
+        static constexpr uint32_t ChunkBits = 10;
+        static constexpr uint32_t ChunkSize = 1u << ChunkBits;
+
+        explicit InterfaceHandleTable(uint32_t capacity = DefaultCapacity)
+            : m_capacity(capacity < MaxCapacity ? capacity : MaxCapacity)
+            , m_chunks(std::make_unique<std::atomic<Slot*>[]>((m_capacity + ChunkSize - 1) / ChunkSize))
+        {
+        }
+
+        InterfaceHandleTable(const InterfaceHandleTable&) = delete;
+        InterfaceHandleTable& operator=(const InterfaceHandleTable&) = delete;
+
+        // Returns the handle of the new slot, or 0 when the table is full
+        uint32_t insert(void* instance)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            
+            uint32_t index = m_free_head;
+            if (index != 0) {
+                m_free_head = getSlot(index)->m_next_free;
+                if (m_free_head == 0) {
+                    m_free_tail = 0;
+                }
+            } else if (m_slot_count + 1 < m_capacity) {
+                index = ++m_slot_count;
+                if (!getSlot(index)) {
+                    addChunk(index >> ChunkBits);
+                }
+            } else {
+                Core::Logger::error("Interface handle table is full, capacity {}", m_capacity);
+                return 0;
+            }
+            
+            // The generation was bumped by remove under the same lock, before the new instance is published
+            Slot& slot = *getSlot(index);
+            slot.m_instance.store(instance, std::memory_order_release);
+            slot.m_next_free = 0;
+            return makeHandle(index, slot.m_generation.load(std::memory_order_relaxed));
+        }
+
+        // Releases the slot and bumps its generation so outstanding copies of the handle stop resolving. Returns the
+        // instance the handle referred to, null when it was already removed, so exactly one of several concurrent
+        // removers of the same handle gets to destroy the instance.
+        void* remove(uint32_t handle)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            
+            Slot* slot = findSlot(handle);
+            if (!slot) {
+                return nullptr;
+            }
+            
+            const uint32_t index = handle & IndexMask;
+            void* instance = slot->m_instance.load(std::memory_order_relaxed);
+            slot->m_instance.store(nullptr, std::memory_order_relaxed);
+            
+            // A slot that used its last generation keeps it and stays empty, every handle to it resolves to null
+            const uint32_t generation = slot->m_generation.load(std::memory_order_relaxed);
+            if (generation == MaxGeneration) {
+                ++m_retired_count;
+                return instance;
+            }
+            
+            slot->m_generation.store(generation + 1, std::memory_order_release);
+            slot->m_next_free = 0;
+            if (m_free_tail != 0) {
+                getSlot(m_free_tail)->m_next_free = index;
+            } else {
+                m_free_head = index;
+            }
+            m_free_tail = index;
+            return instance;
+        }
+
+        // Seqlock-style read: the generation is checked before and again after the instance load, so a slot that
+        // was removed and reused in between is detected by its bumped generation
+        void* resolve(uint32_t handle) const
+        {
+            const uint32_t index = handle & IndexMask;
+            const uint32_t generation = handle >> IndexBits;
+            const Slot* slot = index < m_capacity ? getSlot(index) : nullptr;
+            if (!slot || slot->m_generation.load(std::memory_order_acquire) != generation) {
+                return nullptr;
+            }
+            
+            void* instance = slot->m_instance.load(std::memory_order_acquire);
+            return slot->m_generation.load(std::memory_order_relaxed) == generation ? instance : nullptr;
+        }
+
+        template<class T>
+        T* resolve(uint32_t handle) const
+        {
+            return static_cast<T*>(resolve(handle));
+        }
+
+        // Slots taken out of use after exhausting their generations, they count against the capacity
+        uint32_t getRetiredCount() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_retired_count;
+        }
+
+    private:
+        struct Slot
+        {
+            std::atomic<void*> m_instance{nullptr};
+            std::atomic<uint32_t> m_generation{0};
+            uint32_t m_next_free = 0;       // Only accessed under the table mutex
+        };
+
+        static uint32_t makeHandle(uint32_t index, uint32_t generation)
+        {
+            return (generation << IndexBits) | index;
+        }
+
+        Slot* getSlot(uint32_t index) const
+        {
+            Slot* chunk = m_chunks[index >> ChunkBits].load(std::memory_order_acquire);
+            return chunk ? &chunk[index & (ChunkSize - 1)] : nullptr;
+        }
+
+        void addChunk(uint32_t chunk_index)
+        {
+            m_chunk_storage.emplace_back(std::make_unique<Slot[]>(ChunkSize));
+            m_chunks[chunk_index].store(m_chunk_storage.back().get(), std::memory_order_release);
+        }
+
+        Slot* findSlot(uint32_t handle)
+        {
+            const uint32_t index = handle & IndexMask;
+            Slot* slot = index != 0 && index <= m_slot_count ? getSlot(index) : nullptr;
+            if (!slot || slot->m_generation.load(std::memory_order_relaxed) != (handle >> IndexBits) || 
+                !slot->m_instance.load(std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            return slot;
+        }
+
+        uint32_t m_capacity;
+        std::unique_ptr<std::atomic<Slot*>[]> m_chunks;
+        std::vector<std::unique_ptr<Slot[]>> m_chunk_storage;
+        uint32_t m_slot_count = 0;
+        uint32_t m_free_head = 0;       // Oldest freed slot, reused first
+        uint32_t m_free_tail = 0;       // Most recently freed slot
+        uint32_t m_retired_count = 0;
+        mutable std::mutex m_mutex;
+    };
+
+    // Lookup of handle tables by InterfaceExportInfo::m_interface_type_hash, for hosts that only hold export info
+    class InterfaceHandleTableRegistry
+    {
+    public:
+        static InterfaceHandleTable* find(std::size_t interface_type_hash)
+        {
+            std::lock_guard<std::mutex> lock(getMutex());
+            auto found = getTables().find(interface_type_hash);
+            return found != getTables().end() ? found->second : nullptr;
+        }
+
+        static void add(std::size_t interface_type_hash, InterfaceHandleTable* table)
+        {
+            std::lock_guard<std::mutex> lock(getMutex());
+            getTables()[interface_type_hash] = table;
+        }
+
+    private:
+        static std::unordered_map<std::size_t, InterfaceHandleTable*>& getTables()
+        {
+            static std::unordered_map<std::size_t, InterfaceHandleTable*> tables;
+            return tables;
+        }
+
+        static std::mutex& getMutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+    };
+
+    // The handle table of one interface type, registered under the same type hash InterfaceExportInfo uses
+    template<class T>
+    InterfaceHandleTable& getInterfaceHandleTable()
+    {
+        static InterfaceHandleTable* table = []() {
+            static InterfaceHandleTable instance_table;
+            InterfaceHandleTableRegistry::add(Arieo::Base::ct::genCrc32StringID(typeid(T).name()), &instance_table);
+            return &instance_table;
+        }();
+        return *table;
+    }
+
+#if defined(ARIEO_WASMTIME_LINKER_INSTANCE_HANDLES)
+    inline constexpr bool DefaultUseInstanceHandles = true;
+#else
+    inline constexpr bool DefaultUseInstanceHandles = false;
+#endif
+
+    // Specialize to choose per interface whether guests address instances through 32-bit handles or raw pointers
+    template<class T>
+    struct InterfaceInstanceBinding
+    {
+        static constexpr bool use_handle_table = DefaultUseInstanceHandles;
+    };
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "lib/wasmtime_linker/interface_thread_affinity.h"
+
+#include <chrono>
+#include <future>
+#include <type_traits>
+
+namespace Arieo::Lib::WasmtimeLinker 
+{
+    // Member functions returning std::future<R> or std::shared_future<R> are exported as plain synchronous host
+    // functions: the guest sees an R result, and the calling thread blocks in waitForHostFuture until the future is
+    // ready. The guest call does not suspend, so one thread never interleaves other guest work with the wait.
+    template<typename T>
+    struct HostFuture : std::false_type 
+    {
+        using value_type = T;
+    };
+
+    template<typename R>
+    struct HostFuture<std::future<R>> : std::true_type 
+    {
+        using value_type = R;
+    };
+
+    template<typename R>
+    struct HostFuture<std::shared_future<R>> : std::true_type 
+    {
+        using value_type = R;
+    };
+
+    template<typename T>
+    inline constexpr bool is_host_future_v = HostFuture<T>::value;
+
+    // Result type the guest observes for a member function returning T
+    template<typename T>
+    using HostResultType = typename HostFuture<T>::value_type;
+
+    // Per-thread hook run between bounded waits while a host future is pending. A job system installs one on each
+    // worker to run other ready host jobs or I/O completions during the wait. wasmtime keeps per-thread state for
+    // the active call, so the hook must not enter wasm on this thread itself.
+    struct HostFutureWaitHook
+    {
+        using YieldFn = void(*)(void* user_data);
+
+        YieldFn m_yield = nullptr;
+        void* m_user_data = nullptr;
+        
+        // Longest time the worker blocks on the future between two yields, so an idle hook does not spin.
+        // Completion still wakes the wait early, the interval only bounds the delay before the next yield.
+        std::chrono::microseconds m_poll_interval{100};
+    };
+
+    inline HostFutureWaitHook& getThreadHostFutureWaitHook()
+    {
+        thread_local HostFutureWaitHook wait_hook;
+        return wait_hook;
+    }
+
+    // Installs a wait hook for the current thread and restores the previous one on scope exit
+    class ScopedHostFutureWaitHook
+    {
+    public:
+        explicit ScopedHostFutureWaitHook(HostFutureWaitHook wait_hook)
+            : m_previous(getThreadHostFutureWaitHook())
+        {
+            getThreadHostFutureWaitHook() = wait_hook;
+        }
+
+        ~ScopedHostFutureWaitHook()
+        {
+            getThreadHostFutureWaitHook() = m_previous;
+        }
+
+        ScopedHostFutureWaitHook(const ScopedHostFutureWaitHook&) = delete;
+        ScopedHostFutureWaitHook& operator=(const ScopedHostFutureWaitHook&) = delete;
+
+    private:
+        HostFutureWaitHook m_previous;
+    };
+
+    // Blocking wait for a host future: alternate bounded waits with calls to the thread's wait hook until it is
+    // ready, block outright when no hook is installed
+    template<typename Future>
+    HostResultType<std::remove_cvref_t<Future>> waitForHostFuture(Future&& future)
+    {
+        const HostFutureWaitHook& wait_hook = getThreadHostFutureWaitHook();
+        if (wait_hook.m_yield) {
+            while (future.wait_for(wait_hook.m_poll_interval) != std::future_status::ready) {
+                wait_hook.m_yield(wait_hook.m_user_data);
+            }
+        }
+        return future.get();
+    }
+
+    // Calls that can be queued without waiting: nothing to return and only arguments that own no guest or scratch memory
+    template<typename Ret, typename... Args>
+    inline constexpr bool is_deferrable_host_call_v = 
+        std::is_void_v<Ret> && ((std::is_arithmetic_v<std::remove_cvref_t<Args>> || std::is_enum_v<std::remove_cvref_t<Args>>) && ...);
+
+    // Run a main-thread-only member function through the MainThreadDispatchQueue. A deferred call copies its
+    // arguments, any other call waits, so references into the guest's arguments stay valid until it has run.
+    template<typename Ret, typename Class, typename... Args, typename... Params>
+    HostResultType<Ret> invokeHostMemberOnMainThread(Class* instance, Ret(Class::*func_ptr)(Args...), Params&&... params)
+    {
+        if constexpr (is_deferrable_host_call_v<Ret, Args...>) {
+            getMainThreadDispatchQueue().post(
+                [instance, func_ptr, ...args = static_cast<std::remove_cvref_t<Args>>(params)]() { (instance->*func_ptr)(args...); }
+            );
+        } else {
+            std::packaged_task<Ret()> task([&]() -> Ret { return (instance->*func_ptr)(std::forward<Params>(params)...); });
+            std::future<Ret> call_future = task.get_future();
+            getMainThreadDispatchQueue().post([&task]() { task(); });
+            
+            // A future-returning function hands back its own future, which is waited on here as well rather than on the main thread
+            if constexpr (is_host_future_v<Ret>) {
+                return waitForHostFuture(waitForHostFuture(std::move(call_future)));
+            } else {
+                return waitForHostFuture(std::move(call_future));
+            }
+        }
+    }
+
+    // Invoke a member function and wait on future results, so callers only ever see HostResultType<Ret>.
+    // Calls marked MainThread by ScopedHostCallAffinity are routed to the main thread when made from any other.
+    template<typename Ret, typename Class, typename... Args, typename... Params>
+    HostResultType<Ret> invokeHostMember(Class* instance, Ret(Class::*func_ptr)(Args...), Params&&... params)
+    {
+        if (getThreadHostCallAffinity() == InterfaceFunctionAffinity::MainThread && getMainThreadDispatchQueue().needsDispatch()) {
+            return invokeHostMemberOnMainThread(instance, func_ptr, std::forward<Params>(params)...);
+        }
+        
+        if constexpr (is_host_future_v<Ret>) {
+            return waitForHostFuture((instance->*func_ptr)(std::forward<Params>(params)...));
+        } else {
+            return (instance->*func_ptr)(std::forward<Params>(params)...);
+        }
+    }
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "lib/wasmtime_linker/interface_wasmtime_linker.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Arieo::Lib::WasmtimeLinker
+{
+    // Slab allocator for the host instances of one implementation type. Slabs live as long as the pool, so in steady
+    // state creating and destroying an instance only pops or pushes an intrusive free list under the pool mutex.
+    template<class Impl>
+    class InterfaceInstancePool
+    {
+    public:
+        static constexpr std::size_t DefaultSlabCapacity = 256;
+
+        explicit InterfaceInstancePool(std::size_t slab_capacity = DefaultSlabCapacity)
+            : m_slab_capacity(slab_capacity ? slab_capacity : 1)
+        {
+        }
+
+        InterfaceInstancePool(const InterfaceInstancePool&) = delete;
+        InterfaceInstancePool& operator=(const InterfaceInstancePool&) = delete;
+
+        template<typename... CtorArgs>
+        Impl* create(CtorArgs&&... ctor_args)
+        {
+            void* storage = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                storage = allocateLocked();
+            }
+            return new (storage) Impl(std::forward<CtorArgs>(ctor_args)...);
+        }
+
+        // Fill `instances` under a single lock acquisition, every instance is constructed from the same arguments
+        template<typename... CtorArgs>
+        void createBatch(std::span<Impl*> instances, const CtorArgs&... ctor_args)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (Impl*& instance : instances) {
+                    instance = static_cast<Impl*>(allocateLocked());
+                }
+            }
+
+            for (Impl*& instance : instances) {
+                instance = new (instance) Impl(ctor_args...);
+            }
+        }
+
+        void destroy(Impl* instance)
+        {
+            if (!instance) {
+                return;
+            }
+
+            instance->~Impl();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            deallocateLocked(instance);
+        }
+
+        void destroyBatch(std::span<Impl* const> instances)
+        {
+            for (Impl* instance : instances) {
+                if (instance) {
+                    instance->~Impl();
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (Impl* instance : instances) {
+                if (instance) {
+                    deallocateLocked(instance);
+                }
+            }
+        }
+
+        std::size_t getLiveCount() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_live_count;
+        }
+
+        std::size_t getSlabCount() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_slabs.size();
+        }
+
+    private:
+        union Node
+        {
+            Node* m_next_free;
+            alignas(Impl) std::byte m_storage[sizeof(Impl)];
+        };
+
+        void* allocateLocked()
+        {
+            if (!m_free_head) {
+                // Thread the new slab onto the free list back to front so instances come out in address order
+                m_slabs.emplace_back(std::make_unique<Node[]>(m_slab_capacity));
+                Node* slab = m_slabs.back().get();
+                for (std::size_t i = m_slab_capacity; i > 0; --i) {
+                    slab[i - 1].m_next_free = m_free_head;
+                    m_free_head = &slab[i - 1];
+                }
+            }
+
+            Node* node = m_free_head;
+            m_free_head = node->m_next_free;
+            ++m_live_count;
+            return node->m_storage;
+        }
+
+        void deallocateLocked(void* storage)
+        {
+            Node* node = reinterpret_cast<Node*>(storage);
+            node->m_next_free = m_free_head;
+            m_free_head = node;
+            --m_live_count;
+        }
+
+        std::size_t m_slab_capacity;
+        std::vector<std::unique_ptr<Node[]>> m_slabs;
+        Node* m_free_head = nullptr;
+        std::size_t m_live_count = 0;
+        mutable std::mutex m_mutex;
+    };
+
+    // Create/destroy entry points of a pooled interface, for hosts that only hold InterfaceExportInfo
+    struct InterfaceInstancePoolEntry
+    {
+        std::uint64_t (*m_create)(std::uint64_t, std::uint64_t, std::string_view);
+        void (*m_create_batch)(std::span<std::uint64_t>, std::uint64_t, std::uint64_t, std::string_view);
+        void (*m_destroy)(std::uint64_t);
+    };
+
+    // Lookup of pooled interfaces by InterfaceExportInfo::m_interface_type_hash
+    class InterfaceInstancePoolRegistry
+    {
+    public:
+        static const InterfaceInstancePoolEntry* find(std::size_t interface_type_hash)
+        {
+            std::lock_guard<std::mutex> lock(getMutex());
+            auto found = getEntries().find(interface_type_hash);
+            return found != getEntries().end() ? &found->second : nullptr;
+        }
+
+        static void add(std::size_t interface_type_hash, const InterfaceInstancePoolEntry& entry)
+        {
+            std::lock_guard<std::mutex> lock(getMutex());
+            getEntries()[interface_type_hash] = entry;
+        }
+
+    private:
+        static std::unordered_map<std::size_t, InterfaceInstancePoolEntry>& getEntries()
+        {
+            static std::unordered_map<std::size_t, InterfaceInstancePoolEntry> entries;
+            return entries;
+        }
+
+        static std::mutex& getMutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+    };
+
+    // Pooled host instances of interface T implemented by Impl. The instance value handed to the guest follows
+    // InterfaceInstanceBinding<T>: a handle table entry or the T pointer itself, exactly what resolveInstance expects.
+    // Impl is constructed from the (id, checksum, name) creation arguments when it accepts them, default constructed otherwise.
+    template<class T, class Impl = T>
+    class PooledInterfaceInstances
+    {
+    public:
+        static InterfaceInstancePool<Impl>& getPool()
+        {
+            static InterfaceInstancePool<Impl> pool;
+            return pool;
+        }
+
+        static std::uint64_t create(std::uint64_t interface_id, std::uint64_t interface_checksum, std::string_view name)
+        {
+            Impl* instance = nullptr;
+            if constexpr (std::is_constructible_v<Impl, std::uint64_t, std::uint64_t, std::string_view>) {
+                instance = getPool().create(interface_id, interface_checksum, name);
+            } else {
+                instance = getPool().create();
+            }
+            return toInstanceValue(instance);
+        }
+
+        // Instance values for instance_values.size() new instances, taking the pool lock once per 64 instances
+        static void createBatch(std::span<std::uint64_t> instance_values, std::uint64_t interface_id, std::uint64_t interface_checksum, std::string_view name)
+        {
+            constexpr std::size_t ChunkSize = 64;
+            Impl* instances[ChunkSize];
+            for (std::size_t offset = 0; offset < instance_values.size(); offset += ChunkSize) {
+                const std::size_t count = std::min(ChunkSize, instance_values.size() - offset);
+                if constexpr (std::is_constructible_v<Impl, std::uint64_t, std::uint64_t, std::string_view>) {
+                    getPool().createBatch(std::span<Impl*>(instances, count), interface_id, interface_checksum, name);
+                } else {
+                    getPool().createBatch(std::span<Impl*>(instances, count));
+                }
+                for (std::size_t i = 0; i < count; ++i) {
+                    instance_values[offset + i] = toInstanceValue(instances[i]);
+                }
+            }
+        }
+
+        static void destroy(std::uint64_t instance_value)
+        {
+            T* instance = nullptr;
+            if constexpr (InterfaceInstanceBinding<T>::use_handle_table) {
+                // Resolved and released in one step under the table lock, a stale or repeated destroy finds nothing
+                instance = static_cast<T*>(getInterfaceHandleTable<T>().remove(static_cast<uint32_t>(instance_value)));
+                if (!instance) {
+                    return;
+                }
+            } else {
+                instance = reinterpret_cast<T*>(instance_value);
+            }
+            getPool().destroy(static_cast<Impl*>(instance));
+        }
+
+        // Register under T's interface type hash and return the create callback to hand to the script runtime
+        static InterfaceCreateFunctionHostCallback registerPool()
+        {
+            InterfaceInstancePoolRegistry::add(
+                Arieo::Base::ct::genCrc32StringID(typeid(T).name()),
+                InterfaceInstancePoolEntry{&create, &createBatch, &destroy}
+            );
+            return &create;
+        }
+
+    private:
+        static std::uint64_t toInstanceValue(Impl* instance)
+        {
+            T* interface_instance = instance;
+            if constexpr (InterfaceInstanceBinding<T>::use_handle_table) {
+                const uint32_t handle = getInterfaceHandleTable<T>().insert(interface_instance);
+                if (handle == 0) {
+                    getPool().destroy(instance);
+                }
+                return handle;
+            } else {
+                return reinterpret_cast<std::uint64_t>(interface_instance);
+            }
+        }
+    };
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <wasmtime.hh>
+#include <atomic>
+#include <string_view>
+
+namespace Arieo::Lib::WasmtimeLinker
+{
+    // Let perf/VTune resolve guest frames: Perfmap appends every compiled wasm function to /tmp/perf-<pid>.map,
+    // Jitdump writes jit-<pid>.dump for `perf inject --jit`, Vtune registers the code through the JIT profiling API.
+    // This covers guest code only, host frames keep their ELF symbols (see InterfaceProfilerHooks).
+    // Like the other engine settings, this must be applied to the Config before the Engine is created.
+    inline void configureProfiling(wasmtime::Config& config, wasmtime::ProfilingStrategy strategy)
+    {
+        config.profiler(strategy);
+    }
+
+    // Zone markers for instrumenting profilers (Tracy, ITT, Superluminal, ...). Every generated host callback opens
+    // a zone named after its interface and function, e.g. arieo:engine/transform + set-position, so host time is
+    // attributed per WIT function rather than per shared trampoline instantiation.
+    // Sampling profilers get no such attribution: no perf map or ITT entry is written per host function, and
+    // runtime callbacks with the same signature share one storedHostTrampoline, so their samples land on that
+    // anonymous symbol. Per-function host timings need these zones or the call stats.
+    // Zones are compiled in with ARIEO_WASMTIME_LINKER_PROFILER_ZONES, the names point into the export info and
+    // stay valid as long as the plugin that exported them is loaded.
+    struct InterfaceProfilerHooks
+    {
+        void (*m_begin_zone)(std::string_view interface_name, std::string_view function_name, void* user_data) = nullptr;
+        void (*m_end_zone)(void* user_data) = nullptr;
+        void* m_user_data = nullptr;
+    };
+
+    inline std::atomic<const InterfaceProfilerHooks*>& getInterfaceProfilerHooksStorage()
+    {
+        static std::atomic<const InterfaceProfilerHooks*> profiler_hooks{nullptr};
+        return profiler_hooks;
+    }
+
+    // Install the hooks, or remove them with null. Both callbacks must be set, and the hooks object must outlive
+    // every call made while it is installed.
+    inline void setInterfaceProfilerHooks(const InterfaceProfilerHooks* profiler_hooks)
+    {
+        getInterfaceProfilerHooksStorage().store(profiler_hooks, std::memory_order_release);
+    }
+
+    // Brackets one host call with the installed hooks, a no-op without hooks or when zones are compiled out
+    class ScopedProfilerZone
+    {
+    public:
+#if defined(ARIEO_WASMTIME_LINKER_PROFILER_ZONES)
+        ScopedProfilerZone(std::string_view interface_name, std::string_view function_name)
+            : m_profiler_hooks(getInterfaceProfilerHooksStorage().load(std::memory_order_acquire))
+        {
+            if (m_profiler_hooks) {
+                m_profiler_hooks->m_begin_zone(interface_name, function_name, m_profiler_hooks->m_user_data);
+            }
+        }
+
+        ~ScopedProfilerZone()
+        {
+            if (m_profiler_hooks) {
+                m_profiler_hooks->m_end_zone(m_profiler_hooks->m_user_data);
+            }
+        }
+
+    private:
+        const InterfaceProfilerHooks* m_profiler_hooks;
+#else
+        ScopedProfilerZone(std::string_view, std::string_view) {}
+#endif
+    public:
+        ScopedProfilerZone(const ScopedProfilerZone&) = delete;
+        ScopedProfilerZone& operator=(const ScopedProfilerZone&) = delete;
+    };
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace Arieo::Lib::WasmtimeLinker
+{
+    // Monotonic scratch memory for the temporaries of one host call, decoded argument lists in particular.
+    // Blocks taken from the heap are kept across resets, so once the arena has grown to fit the largest call it
+    // serves every later call without touching the heap. Only argument decoding uses it: scalar results are plain
+    // Vals, but record, tuple, list and batch results are built through wasmtime's Record/Tuple/List, which take a
+    // std::vector and copy it into storage wasmtime owns, so those returns still allocate on every call.
+    class InterfaceScratchArena : public std::pmr::memory_resource
+    {
+    public:
+        static constexpr std::size_t DefaultBlockSize = 16 * 1024;
+
+        explicit InterfaceScratchArena(std::size_t block_size = DefaultBlockSize)
+            : m_block_size(block_size)
+        {
+        }
+
+        InterfaceScratchArena(const InterfaceScratchArena&) = delete;
+        InterfaceScratchArena& operator=(const InterfaceScratchArena&) = delete;
+
+        // Rewind to the first block, every block is kept for reuse
+        void reset()
+        {
+            m_block_index = 0;
+            m_offset = 0;
+            m_used_bytes = 0;
+        }
+
+        // Blocks requested from the heap over the arena's lifetime, stays flat once calls reach steady state
+        std::size_t getHeapAllocationCount() const { return m_heap_allocation_count; }
+
+        // Largest number of bytes handed out between two resets
+        std::size_t getHighWaterMark() const { return m_high_water_mark; }
+
+    private:
+        friend class ScopedScratchArenaFrame;
+
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> m_bytes;
+            std::size_t m_size = 0;
+        };
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            while (true) {
+                if (m_block_index < m_blocks.size()) {
+                    Block& block = m_blocks[m_block_index];
+                    const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.m_bytes.get());
+                    const std::uintptr_t aligned = (base + m_offset + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+                    const std::size_t offset = static_cast<std::size_t>(aligned - base);
+                    if (offset + bytes <= block.m_size) {
+                        m_used_bytes += offset + bytes - m_offset;
+                        m_high_water_mark = std::max(m_high_water_mark, m_used_bytes);
+                        m_offset = offset + bytes;
+                        return reinterpret_cast<void*>(aligned);
+                    }
+
+                    ++m_block_index;
+                    m_offset = 0;
+                    continue;
+                }
+
+                const std::size_t size = std::max(m_block_size, bytes + alignment);
+                m_blocks.push_back(Block{std::make_unique<std::byte[]>(size), size});
+                ++m_heap_allocation_count;
+            }
+        }
+
+        void do_deallocate(void*, std::size_t, std::size_t) override
+        {
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        std::size_t m_block_size;
+        std::vector<Block> m_blocks;
+        std::size_t m_block_index = 0;
+        std::size_t m_offset = 0;
+        std::size_t m_used_bytes = 0;
+        std::size_t m_high_water_mark = 0;
+        std::size_t m_heap_allocation_count = 0;
+
+        // Nesting depth of host calls using the arena
+        std::size_t m_frame_depth = 0;
+    };
+
+    // Arena installed for the current thread. With one store per worker thread this is the store's arena; threads
+    // without an installed arena fall back to a thread-local one.
+    inline InterfaceScratchArena*& getThreadScratchArenaSlot()
+    {
+        thread_local InterfaceScratchArena* arena = nullptr;
+        return arena;
+    }
+
+    inline InterfaceScratchArena& getThreadScratchArena()
+    {
+        InterfaceScratchArena* arena = getThreadScratchArenaSlot();
+        if (arena) {
+            return *arena;
+        }
+
+        thread_local InterfaceScratchArena fallback_arena;
+        return fallback_arena;
+    }
+
+    // Installs an arena for the current thread and restores the previous one on scope exit
+    class ScopedInterfaceScratchArena
+    {
+    public:
+        explicit ScopedInterfaceScratchArena(InterfaceScratchArena& arena)
+            : m_previous(getThreadScratchArenaSlot())
+        {
+            getThreadScratchArenaSlot() = &arena;
+        }
+
+        ~ScopedInterfaceScratchArena()
+        {
+            getThreadScratchArenaSlot() = m_previous;
+        }
+
+        ScopedInterfaceScratchArena(const ScopedInterfaceScratchArena&) = delete;
+        ScopedInterfaceScratchArena& operator=(const ScopedInterfaceScratchArena&) = delete;
+
+    private:
+        InterfaceScratchArena* m_previous;
+    };
+
+    // Spans one host call, the arena is reset when the outermost call returns so nested host calls reached through
+    // a guest re-entry keep their caller's temporaries alive
+    class ScopedScratchArenaFrame
+    {
+    public:
+        explicit ScopedScratchArenaFrame(InterfaceScratchArena& arena)
+            : m_arena(arena)
+        {
+            ++m_arena.m_frame_depth;
+        }
+
+        ~ScopedScratchArenaFrame()
+        {
+            if (--m_arena.m_frame_depth == 0) {
+                m_arena.reset();
+            }
+        }
+
+        ScopedScratchArenaFrame(const ScopedScratchArenaFrame&) = delete;
+        ScopedScratchArenaFrame& operator=(const ScopedScratchArenaFrame&) = delete;
+
+    private:
+        InterfaceScratchArena& m_arena;
+    };
+}
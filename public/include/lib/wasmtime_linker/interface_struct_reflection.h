@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Arieo::Lib::WasmtimeLinker 
+{
+    // Stand-in convertible to any field type, used to count the fields of an aggregate by brace initialization
+    struct AggregateFieldProbe
+    {
+        template<typename U>
+        constexpr operator U() const noexcept;
+    };
+
+    inline constexpr std::size_t MaxReflectedFieldCount = 12;
+
+    // Probing stops one past the reflected maximum, so initializer-list constructible types cannot recurse forever
+    template<typename T, typename... Probes>
+    constexpr std::size_t aggregateFieldCount()
+    {
+        if constexpr (sizeof...(Probes) > MaxReflectedFieldCount) {
+            return sizeof...(Probes);
+        } else if constexpr (requires { T{Probes{}..., AggregateFieldProbe{}}; }) {
+            return aggregateFieldCount<T, Probes..., AggregateFieldProbe>();
+        } else {
+            return sizeof...(Probes);
+        }
+    }
+
+    template<typename T>
+    concept TupleLike = requires { std::tuple_size<std::remove_cv_t<T>>::value; };
+
+    // Trivially copyable aggregates marshal as WIT records, field by field in declaration order
+    template<typename T>
+    inline constexpr bool is_wit_record_v = 
+        std::is_class_v<T> && std::is_aggregate_v<T> && std::is_trivially_copyable_v<T> && !TupleLike<T> &&
+        aggregateFieldCount<T>() > 0 && aggregateFieldCount<T>() <= MaxReflectedFieldCount;
+
+    // std::tuple, std::pair and std::array marshal as WIT tuples
+    template<typename T>
+    inline constexpr bool is_wit_tuple_v = TupleLike<T> && !std::is_reference_v<T>;
+
+    // References to the fields of an aggregate as a tuple, through structured bindings
+    template<typename T>
+    constexpr auto tieFields(T& value)
+    {
+        constexpr std::size_t count = aggregateFieldCount<std::remove_const_t<T>>();
+        if constexpr (count == 1) {
+            auto& [f0] = value;
+            return std::tie(f0);
+        } else if constexpr (count == 2) {
+            auto& [f0, f1] = value;
+            return std::tie(f0, f1);
+        } else if constexpr (count == 3) {
+            auto& [f0, f1, f2] = value;
+            return std::tie(f0, f1, f2);
+        } else if constexpr (count == 4) {
+            auto& [f0, f1, f2, f3] = value;
+            return std::tie(f0, f1, f2, f3);
+        } else if constexpr (count == 5) {
+            auto& [f0, f1, f2, f3, f4] = value;
+            return std::tie(f0, f1, f2, f3, f4);
+        } else if constexpr (count == 6) {
+            auto& [f0, f1, f2, f3, f4, f5] = value;
+            return std::tie(f0, f1, f2, f3, f4, f5);
+        } else if constexpr (count == 7) {
+            auto& [f0, f1, f2, f3, f4, f5, f6] = value;
+            return std::tie(f0, f1, f2, f3, f4, f5, f6);
+        } else if constexpr (count == 8) {
+            auto& [f0, f1, f2, f3, f4, f5, f6, f7] = value;
+            return std::tie(f0, f1, f2, f3, f4, f5, f6, f7);
+        } else if constexpr (count == 9) {
+            auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8] = value;
+            return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8);
+        } else if constexpr (count == 10) {
+            auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9] = value;
+            return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9);
+        } else if constexpr (count == 11) {
+            auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10] = value;
+            return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10);
+        } else {
+            static_assert(count == 12, "aggregate has more fields than MaxReflectedFieldCount");
+            auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11] = value;
+            return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11);
+        }
+    }
+
+    // Field access shared by records and tuples
+    template<typename T>
+    constexpr auto tieElements(T& value)
+    {
+        if constexpr (TupleLike<T>) {
+            return std::apply([](auto&... elements) { return std::tie(elements...); }, value);
+        } else {
+            return tieFields(value);
+        }
+    }
+
+    template<typename T>
+    using ElementTieType = decltype(tieElements(std::declval<T&>()));
+
+    template<typename T>
+    inline constexpr std::size_t element_count_v = std::tuple_size_v<ElementTieType<T>>;
+
+    template<typename T, std::size_t I>
+    using ElementType = std::remove_cvref_t<std::tuple_element_t<I, ElementTieType<T>>>;
+}
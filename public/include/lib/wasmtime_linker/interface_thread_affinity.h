@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace Arieo::Lib::WasmtimeLinker
+{
+    // Thread a host member function must run on, recorded per function in InterfaceFunctionExportInfo::m_affinity
+    enum class InterfaceFunctionAffinity : uint8_t
+    {
+        Any,        // Runs on the thread of the calling guest
+        MainThread  // Runs on the thread bound to the MainThreadDispatchQueue, e.g. render and window interfaces
+    };
+
+    // Specialize to tag the member functions of interface T, the WIT function name identifies the member
+    template<class T>
+    struct InterfaceThreadAffinity
+    {
+        static constexpr InterfaceFunctionAffinity getFunctionAffinity(std::string_view)
+        {
+            return InterfaceFunctionAffinity::Any;
+        }
+    };
+
+    // Calls from guests on worker threads to main-thread-only functions. Calls without a result and with only
+    // scalar arguments are deferred: queued and executed in order at the next drain while the guest keeps running.
+    // Every other call is queued the same way and the guest's thread blocks on the result through its
+    // HostFutureWaitHook, so the main thread must keep draining while scripts run on workers. Host instances
+    // reached by deferred calls must outlive the next drain. Batch variants of value-returning functions wait
+    // once per element.
+    class MainThreadDispatchQueue
+    {
+    public:
+        using Task = std::function<void()>;
+
+        // Call once from the main thread; until then main-thread-only functions run on the calling thread
+        void bindMainThread()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_main_thread_id = std::this_thread::get_id();
+            m_bound = true;
+        }
+
+        // True when a call on the current thread has to be handed to the main thread
+        bool needsDispatch() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_bound && m_main_thread_id != std::this_thread::get_id();
+        }
+
+        void post(Task task)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending_tasks.push_back(std::move(task));
+        }
+
+        // Run everything queued so far on the calling (main) thread, returns the number of tasks run.
+        // Tasks queued by the tasks themselves wait for the next drain.
+        size_t drain()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_running_tasks.swap(m_pending_tasks);
+            }
+
+            for (Task& task : m_running_tasks) {
+                task();
+            }
+
+            const size_t task_count = m_running_tasks.size();
+            m_running_tasks.clear();
+            return task_count;
+        }
+
+        size_t getPendingCount() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_pending_tasks.size();
+        }
+
+    private:
+        mutable std::mutex m_mutex;
+        std::vector<Task> m_pending_tasks;
+        std::vector<Task> m_running_tasks;     // Only touched by the draining thread, kept to reuse its capacity
+        std::thread::id m_main_thread_id;
+        bool m_bound = false;
+    };
+
+    inline MainThreadDispatchQueue& getMainThreadDispatchQueue()
+    {
+        static MainThreadDispatchQueue dispatch_queue;
+        return dispatch_queue;
+    }
+
+    // Affinity of the host call the current thread is executing, read by invokeHostMember
+    inline InterfaceFunctionAffinity& getThreadHostCallAffinity()
+    {
+        thread_local InterfaceFunctionAffinity affinity = InterfaceFunctionAffinity::Any;
+        return affinity;
+    }
+
+    // Marks the host call made within the scope, restoring the previous affinity on exit
+    class ScopedHostCallAffinity
+    {
+    public:
+        explicit ScopedHostCallAffinity(InterfaceFunctionAffinity affinity)
+            : m_previous(getThreadHostCallAffinity())
+        {
+            getThreadHostCallAffinity() = affinity;
+        }
+
+        ~ScopedHostCallAffinity()
+        {
+            getThreadHostCallAffinity() = m_previous;
+        }
+
+        ScopedHostCallAffinity(const ScopedHostCallAffinity&) = delete;
+        ScopedHostCallAffinity& operator=(const ScopedHostCallAffinity&) = delete;
+
+    private:
+        InterfaceFunctionAffinity m_previous;
+    };
+}
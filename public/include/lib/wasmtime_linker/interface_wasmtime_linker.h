@@ -1,11 +1,34 @@
 #pragma once
 
 #include "core/module/module.h"
+#include "lib/wasmtime_linker/interface_host_future.h"
+#include "lib/wasmtime_linker/interface_call_stats.h"
+#include "lib/wasmtime_linker/interface_handle_table.h"
+#include "lib/wasmtime_linker/interface_profiling.h"
+#include "lib/wasmtime_linker/interface_scratch_arena.h"
+#include "lib/wasmtime_linker/interface_struct_reflection.h"
+#include "lib/wasmtime_linker/interruption_policy.h"
 
 #include <wasmtime.hh>
 #include <wasmtime/component.hh>
 #include <string>
 #include <cctype>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <version>
+#if defined(__cpp_lib_expected)
+#include <expected>
+#endif
 
 
 namespace Arieo::Lib::WasmtimeLinker 
@@ -23,15 +46,194 @@ namespace Arieo::Lib::WasmtimeLinker
         using type = std::index_sequence_for<Args...>;
     };
 
+    // WIT list<E> parameters and results: std::vector<E> by value, or a std::span<const E> parameter viewing
+    // contiguous host storage decoded once per call (see decodeParam). By-value std::vector parameters heap-allocate
+    // on every call, so only the diagnostic path accepts them, the fast path requires std::span<const E>.
+    template<typename T>
+    struct ListParam : std::false_type {};
+
+    template<typename Element>
+    struct ListParam<std::vector<Element>> : std::true_type 
+    {
+        using element_type = Element;
+    };
+
+    template<typename Element>
+    struct ListParam<std::span<const Element>> : std::true_type 
+    {
+        using element_type = Element;
+    };
+
+    template<typename T>
+    inline constexpr bool is_wit_list_v = ListParam<T>::value;
+
+    template<typename T>
+    inline constexpr bool is_wit_vector_v = false;
+
+    template<typename Element>
+    inline constexpr bool is_wit_vector_v<std::vector<Element>> = true;
+
+    // std::expected<T, E> results marshal as WIT result<T, E>, so host failures reach the guest as a typed error
+    // value instead of a trap. E is usually an enum error code, enums marshal as their underlying integer.
+    template<typename T>
+    inline constexpr bool is_wit_result_v = false;
+
+#if defined(__cpp_lib_expected)
+    template<typename Value, typename Error>
+    inline constexpr bool is_wit_result_v<std::expected<Value, Error>> = true;
+#endif
+
+    template<typename T>
+    T extractValue(const wasmtime::component::Val& val, std::size_t index);
+
+    template<typename T>
+    T extractValueUnchecked(const wasmtime::component::Val& val);
+
+    template<typename T>
+    bool isValTypeOf(const wasmtime::component::ValType& val_type);
+
+    // Bulk decode a homogeneous list into contiguous storage. The unchecked form relies on the list<E> type
+    // validated at link time, so the loop carries no tag branches and reduces to a strided load/store.
+    template<typename Element, bool Checked>
+    void copyListElements(const wasmtime::component::List& list, Element* out)
+    {
+        const wasmtime::component::Val* vals = list.begin();
+        const std::size_t count = list.size();
+        for (std::size_t i = 0; i < count; ++i) {
+            if constexpr (Checked) {
+                out[i] = extractValue<Element>(vals[i], i);
+            } else {
+                out[i] = extractValueUnchecked<Element>(vals[i]);
+            }
+        }
+    }
+
+    template<typename Element, bool Checked, typename Container = std::vector<Element>>
+    Container extractListValue(const wasmtime::component::Val& val, Container elements = {})
+    {
+        if (Checked && !val.is_list()) {
+            return elements;
+        }
+        
+        const wasmtime::component::List& list = val.get_list();
+        elements.resize(list.size());
+        if constexpr (std::is_same_v<Element, bool>) {
+            // vector<bool> packs its bits and has no data(), store element by element
+            const wasmtime::component::Val* vals = list.begin();
+            for (std::size_t i = 0; i < list.size(); ++i) {
+                elements[i] = Checked ? extractValue<bool>(vals[i], i) : extractValueUnchecked<bool>(vals[i]);
+            }
+        } else {
+            copyListElements<Element, Checked>(list, elements.data());
+        }
+        return elements;
+    }
+
+    // Helper to decode a WIT record or tuple into an aggregate or tuple-like value, element by element
+    template<typename T, bool Checked, std::size_t... Is>
+    T extractCompositeValue(const wasmtime::component::Val& val, std::index_sequence<Is...>)
+    {
+        T value{};
+        auto elements = tieElements(value);
+        
+        const wasmtime::component::Val* element_vals[sizeof...(Is) + 1] = {};
+        if constexpr (is_wit_record_v<T>) {
+            if (Checked && (!val.is_record() || val.get_record().size() != sizeof...(Is))) {
+                return value;
+            }
+            const wasmtime::component::RecordField* fields = val.get_record().begin();
+            ((element_vals[Is] = &fields[Is].value()), ...);
+        } else {
+            if (Checked && (!val.is_tuple() || val.get_tuple().size() != sizeof...(Is))) {
+                return value;
+            }
+            const wasmtime::component::Val* tuple_elements = val.get_tuple().begin();
+            ((element_vals[Is] = &tuple_elements[Is]), ...);
+        }
+        
+        if constexpr (Checked) {
+            ((std::get<Is>(elements) = extractValue<ElementType<T, Is>>(*element_vals[Is], Is)), ...);
+        } else {
+            ((std::get<Is>(elements) = extractValueUnchecked<ElementType<T, Is>>(*element_vals[Is])), ...);
+        }
+        return value;
+    }
+
+    // Helper to check a WIT record or tuple type element-wise against an aggregate or tuple-like type
+    template<typename T, std::size_t... Is>
+    bool isCompositeValTypeOf(const wasmtime::component::ValType& val_type, std::index_sequence<Is...>)
+    {
+        if constexpr (is_wit_record_v<T>) {
+            if (!val_type.is_record() || val_type.record_field_count() != sizeof...(Is)) {
+                return false;
+            }
+            auto field_matches = [&val_type](std::size_t index, auto type_tag) {
+                auto field = val_type.record_field_nth(index);
+                return field && isValTypeOf<typename decltype(type_tag)::type>(field->second);
+            };
+            return (field_matches(Is, std::type_identity<ElementType<T, Is>>{}) && ...);
+        } else {
+            if (!val_type.is_tuple() || val_type.tuple_element_count() != sizeof...(Is)) {
+                return false;
+            }
+            auto element_matches = [&val_type](std::size_t index, auto type_tag) {
+                auto element = val_type.tuple_element_nth(index);
+                return element && isValTypeOf<typename decltype(type_tag)::type>(*element);
+            };
+            return (element_matches(Is, std::type_identity<ElementType<T, Is>>{}) && ...);
+        }
+    }
+
     // Helper to extract value from WASM Val based on type
     template<typename T>
     T extractValue(const wasmtime::component::Val& val, std::size_t index)
     {
-        if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, int>) {
+        if constexpr (std::is_same_v<T, bool>) {
+            if (val.is_bool()) {
+                return val.get_bool();
+            }
+        }
+        else if constexpr (std::is_same_v<T, int8_t>) {
+            if (val.is_s8()) {
+                return val.get_s8();
+            }
+        }
+        else if constexpr (std::is_same_v<T, uint8_t>) {
+            if (val.is_u8()) {
+                return val.get_u8();
+            }
+        }
+        else if constexpr (std::is_same_v<T, std::byte>) {
+            if (val.is_u8()) {
+                return std::byte(val.get_u8());
+            }
+        }
+        else if constexpr (std::is_same_v<T, int16_t>) {
+            if (val.is_s16()) {
+                return val.get_s16();
+            }
+        }
+        else if constexpr (std::is_same_v<T, uint16_t>) {
+            if (val.is_u16()) {
+                return val.get_u16();
+            }
+        }
+        else if constexpr (std::is_same_v<T, char32_t>) {
+            // WIT char is a Unicode scalar value
+            if (val.is_char()) {
+                return static_cast<char32_t>(val.get_char());
+            }
+        }
+        else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, int>) {
             if (val.is_s32()) {
                 return val.get_s32();
             }
         }
+        else if constexpr (std::is_same_v<T, uint32_t>) {
+            if (val.is_u32()) {
+                return val.get_u32();
+            }
+        }
         else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, long long>) {
             if (val.is_s64()) {
                 return val.get_s64();
@@ -50,118 +252,1243 @@ namespace Arieo::Lib::WasmtimeLinker
             if (val.is_f32()) {
                 return val.get_f32();
             }
-        }
-        else if constexpr (std::is_same_v<T, double>) {
-            if (val.is_f64()) {
-                return val.get_f64();
+        }
+        else if constexpr (std::is_same_v<T, double>) {
+            if (val.is_f64()) {
+                return val.get_f64();
+            }
+        }
+        else if constexpr (std::is_same_v<T, std::string_view>) {
+            // Views the string held by the Val, valid for the duration of the call
+            if (val.is_string()) {
+                return val.get_string();
+            }
+        }
+        else if constexpr (is_wit_record_v<T> || is_wit_tuple_v<T>) {
+            return extractCompositeValue<T, true>(val, std::make_index_sequence<element_count_v<T>>{});
+        }
+        else if constexpr (is_wit_vector_v<T>) {
+            return extractListValue<typename ListParam<T>::element_type, true>(val);
+        }
+        else if constexpr (std::is_enum_v<T>) {
+            return static_cast<T>(extractValue<std::underlying_type_t<T>>(val, index));
+        }
+        return T{};
+    }
+
+    // Extract without probing the Val kind, only valid once the signature was checked by validateSignature
+    template<typename T>
+    T extractValueUnchecked(const wasmtime::component::Val& val)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            return val.get_bool();
+        }
+        else if constexpr (std::is_same_v<T, int8_t>) {
+            return val.get_s8();
+        }
+        else if constexpr (std::is_same_v<T, uint8_t>) {
+            return val.get_u8();
+        }
+        else if constexpr (std::is_same_v<T, std::byte>) {
+            return std::byte(val.get_u8());
+        }
+        else if constexpr (std::is_same_v<T, int16_t>) {
+            return val.get_s16();
+        }
+        else if constexpr (std::is_same_v<T, uint16_t>) {
+            return val.get_u16();
+        }
+        else if constexpr (std::is_same_v<T, char32_t>) {
+            return static_cast<char32_t>(val.get_char());
+        }
+        else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, int>) {
+            return val.get_s32();
+        }
+        else if constexpr (std::is_same_v<T, uint32_t>) {
+            return val.get_u32();
+        }
+        else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, long long>) {
+            // Handle/pointer types may arrive as u64, the validator accepts both
+            return val.is_u64() ? static_cast<int64_t>(val.get_u64()) : val.get_s64();
+        }
+        else if constexpr (std::is_same_v<T, uint64_t> || std::is_same_v<T, unsigned long long>) {
+            return val.get_u64();
+        }
+        else if constexpr (std::is_same_v<T, float>) {
+            return val.get_f32();
+        }
+        else if constexpr (std::is_same_v<T, double>) {
+            return val.get_f64();
+        }
+        else if constexpr (std::is_same_v<T, std::string_view>) {
+            return val.get_string();
+        }
+        else if constexpr (is_wit_record_v<T> || is_wit_tuple_v<T>) {
+            return extractCompositeValue<T, false>(val, std::make_index_sequence<element_count_v<T>>{});
+        }
+        else if constexpr (is_wit_vector_v<T>) {
+            static_assert(!is_wit_vector_v<T>, 
+                "by-value std::vector parameters allocate on every call, take std::span<const E> on the fast path");
+            return T{};
+        }
+        else if constexpr (std::is_enum_v<T>) {
+            return static_cast<T>(extractValueUnchecked<std::underlying_type_t<T>>(val));
+        }
+        else {
+            return T{};
+        }
+    }
+
+    // Helper to check a component value type against the C++ type it is extracted as or created from
+    template<typename T>
+    bool isValTypeOf(const wasmtime::component::ValType& val_type)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            return val_type.is_bool();
+        }
+        else if constexpr (std::is_same_v<T, int8_t>) {
+            return val_type.is_s8();
+        }
+        else if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, std::byte>) {
+            return val_type.is_u8();
+        }
+        else if constexpr (std::is_same_v<T, int16_t>) {
+            return val_type.is_s16();
+        }
+        else if constexpr (std::is_same_v<T, uint16_t>) {
+            return val_type.is_u16();
+        }
+        else if constexpr (std::is_same_v<T, char32_t>) {
+            return val_type.is_char();
+        }
+        else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, int>) {
+            return val_type.is_s32();
+        }
+        else if constexpr (std::is_same_v<T, uint32_t>) {
+            return val_type.is_u32();
+        }
+        else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, long long>) {
+            return val_type.is_s64() || val_type.is_u64();
+        }
+        else if constexpr (std::is_same_v<T, uint64_t> || std::is_same_v<T, unsigned long long>) {
+            return val_type.is_u64();
+        }
+        else if constexpr (std::is_same_v<T, float>) {
+            return val_type.is_f32();
+        }
+        else if constexpr (std::is_same_v<T, double>) {
+            return val_type.is_f64();
+        }
+        else if constexpr (std::is_same_v<T, std::string_view>) {
+            return val_type.is_string();
+        }
+        else if constexpr (is_wit_record_v<T> || is_wit_tuple_v<T>) {
+            return isCompositeValTypeOf<T>(val_type, std::make_index_sequence<element_count_v<T>>{});
+        }
+        else if constexpr (is_wit_list_v<T>) {
+            return val_type.is_list() && isValTypeOf<typename ListParam<T>::element_type>(val_type.list_element());
+        }
+        else if constexpr (is_wit_result_v<T>) {
+            if (!val_type.is_result()) {
+                return false;
+            }
+            
+            const auto ok_type = val_type.result_ok();
+            const auto err_type = val_type.result_err();
+            bool ok_matches = false;
+            if constexpr (std::is_void_v<typename T::value_type>) {
+                ok_matches = !ok_type;
+            } else {
+                ok_matches = ok_type && isValTypeOf<typename T::value_type>(*ok_type);
+            }
+            return ok_matches && err_type && isValTypeOf<typename T::error_type>(*err_type);
+        }
+        else if constexpr (std::is_enum_v<T>) {
+            return isValTypeOf<std::underlying_type_t<T>>(val_type);
+        }
+        return false;
+    }
+
+    // Helper to turn a parameter into something the logger can format, spans are logged by element count
+    template<typename T>
+    auto toLoggableValue(const T& value)
+    {
+        if constexpr (requires { value.size(); } && !std::is_same_v<T, std::string_view>) {
+            return value.size();
+        } else if constexpr (is_wit_record_v<T> || is_wit_tuple_v<T>) {
+            return std::string_view(is_wit_record_v<T> ? "<record>" : "<tuple>");
+        } else if constexpr (std::is_same_v<T, char32_t>) {
+            return static_cast<uint32_t>(value);
+        } else if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t> || std::is_same_v<T, std::byte>) {
+            return static_cast<int32_t>(value);
+        } else if constexpr (is_wit_result_v<T>) {
+            return std::string_view(value.has_value() ? "<ok>" : "<err>");
+        } else if constexpr (std::is_enum_v<T>) {
+            return static_cast<std::underlying_type_t<T>>(value);
+        } else {
+            return value;
+        }
+    }
+
+    template<typename T>
+    inline constexpr bool dependent_false_v = false;
+
+    // Helper to convert C++ return value to WASM Val type, narrow types keep their natural width
+    template<typename Ret>
+    wasmtime::component::Val createResultVal(const Ret& result)
+    {
+        if constexpr (std::is_same_v<Ret, bool> || std::is_same_v<Ret, int8_t> || std::is_same_v<Ret, uint8_t> ||
+                      std::is_same_v<Ret, int16_t> || std::is_same_v<Ret, uint16_t> || std::is_same_v<Ret, uint32_t>) {
+            return wasmtime::component::Val(result);
+        }
+        else if constexpr (std::is_same_v<Ret, std::byte>) {
+            return wasmtime::component::Val(static_cast<uint8_t>(result));
+        }
+        else if constexpr (std::is_same_v<Ret, char32_t>) {
+            return wasmtime::component::Val::from_char(static_cast<uint32_t>(result));
+        }
+        else if constexpr (std::is_same_v<Ret, int32_t> || std::is_same_v<Ret, int>) {
+            return wasmtime::component::Val(static_cast<int32_t>(result));
+        }
+        else if constexpr (std::is_same_v<Ret, int64_t> || std::is_same_v<Ret, long long>) {
+            return wasmtime::component::Val(static_cast<int64_t>(result));
+        }
+        else if constexpr (std::is_same_v<Ret, uint64_t> || std::is_same_v<Ret, unsigned long long>) {
+            return wasmtime::component::Val(static_cast<uint64_t>(result));
+        }
+        else if constexpr (std::is_same_v<Ret, float>) {
+            return wasmtime::component::Val(result);
+        }
+        else if constexpr (std::is_same_v<Ret, double>) {
+            return wasmtime::component::Val(result);
+        }
+        else if constexpr (is_wit_list_v<Ret>) {
+            // One Val per element is unavoidable for component lists, reserve once and convert in a tight loop
+            std::vector<wasmtime::component::Val> vals;
+            vals.reserve(result.size());
+            for (const auto& element : result) {
+                vals.emplace_back(createResultVal(element));
+            }
+            return wasmtime::component::Val(wasmtime::component::List(std::move(vals)));
+        }
+        else if constexpr (std::is_enum_v<Ret>) {
+            return createResultVal(static_cast<std::underlying_type_t<Ret>>(result));
+        }
+        else {
+            static_assert(dependent_false_v<Ret>, "return type has no component model mapping");
+        }
+    }
+
+    template<typename T>
+    wasmtime::component::Val createValOfType(const T& value, const wasmtime::component::ValType& val_type);
+
+    // Helper to build a WIT record or tuple, record field names come from the guest's type. Allocates per call:
+    // wasmtime's Record and Tuple only accept a std::vector, which they copy into wasmtime-owned storage.
+    template<typename T, std::size_t... Is>
+    wasmtime::component::Val createCompositeVal(const T& value, const wasmtime::component::ValType& val_type, std::index_sequence<Is...>)
+    {
+        auto elements = tieElements(value);
+        if constexpr (is_wit_record_v<T>) {
+            std::vector<std::pair<std::string_view, wasmtime::component::Val>> fields;
+            fields.reserve(sizeof...(Is));
+            auto add_field = [&fields, &val_type](std::size_t index, const auto& element) {
+                auto field_type = *val_type.record_field_nth(index);
+                fields.emplace_back(field_type.first, createValOfType(element, field_type.second));
+            };
+            (add_field(Is, std::get<Is>(elements)), ...);
+            return wasmtime::component::Val(wasmtime::component::Record(std::move(fields)));
+        } else {
+            std::vector<wasmtime::component::Val> tuple_elements;
+            tuple_elements.reserve(sizeof...(Is));
+            (tuple_elements.emplace_back(createValOfType(std::get<Is>(elements), *val_type.tuple_element_nth(Is))), ...);
+            return wasmtime::component::Val(wasmtime::component::Tuple(std::move(tuple_elements)));
+        }
+    }
+
+    // Helper to convert a C++ value to a Val of the given guest type, scalars ignore the type
+    template<typename T>
+    wasmtime::component::Val createValOfType(const T& value, const wasmtime::component::ValType& val_type)
+    {
+        if constexpr (is_wit_record_v<T> || is_wit_tuple_v<T>) {
+            return createCompositeVal(value, val_type, std::make_index_sequence<element_count_v<T>>{});
+        } else if constexpr (is_wit_result_v<T>) {
+            if (!value.has_value()) {
+                return wasmtime::component::Val(wasmtime::component::WitResult::err(createValOfType(value.error(), *val_type.result_err())));
+            }
+            if constexpr (std::is_void_v<typename T::value_type>) {
+                return wasmtime::component::Val(wasmtime::component::WitResult::ok(std::nullopt));
+            } else {
+                return wasmtime::component::Val(wasmtime::component::WitResult::ok(createValOfType(*value, *val_type.result_ok())));
+            }
+        } else {
+            return createResultVal(value);
+        }
+    }
+
+    // Helper to convert a function's C++ return value, only composite results look at the guest function type
+    template<typename Ret>
+    wasmtime::component::Val createFunctionResultVal(const Ret& result, const wasmtime::component::FuncType& func_type)
+    {
+        if constexpr (is_wit_record_v<Ret> || is_wit_tuple_v<Ret> || is_wit_result_v<Ret>) {
+            return createValOfType(result, *func_type.result_nth(0));
+        } else {
+            return createResultVal(result);
+        }
+    }
+
+    // Per-call owner of a decoded list, converts to the std::span<const E> parameter. Being a temporary of the
+    // call expression, the storage lives until the member function returns. Elements live in the thread's
+    // scratch arena, so steady-state calls do not allocate.
+    template<typename Element>
+    struct DecodedList
+    {
+        std::pmr::vector<Element> m_storage;
+
+        template<bool Checked>
+        static DecodedList decode(const wasmtime::component::Val& val)
+        {
+            return DecodedList{extractListValue<Element, Checked>(val, std::pmr::vector<Element>(&getThreadScratchArena()))};
+        }
+
+        operator std::span<const Element>() const { return m_storage; }
+        std::size_t size() const { return m_storage.size(); }
+    };
+
+    // std::pmr::vector<bool> packs its bits and cannot back a std::span<const bool>, bools are decoded into a
+    // plain bool array taken from the arena instead
+    template<>
+    struct DecodedList<bool>
+    {
+        std::pmr::memory_resource* m_resource = nullptr;
+        bool* m_data = nullptr;
+        std::size_t m_size = 0;
+
+        template<bool Checked>
+        static DecodedList decode(const wasmtime::component::Val& val)
+        {
+            if (Checked && !val.is_list()) {
+                return DecodedList{};
+            }
+            
+            const wasmtime::component::List& list = val.get_list();
+            std::pmr::memory_resource* resource = &getThreadScratchArena();
+            bool* data = list.size() != 0 ? static_cast<bool*>(resource->allocate(list.size() * sizeof(bool), alignof(bool))) : nullptr;
+            copyListElements<bool, Checked>(list, data);
+            return DecodedList{resource, data, list.size()};
+        }
+
+        DecodedList() = default;
+        DecodedList(std::pmr::memory_resource* resource, bool* data, std::size_t size)
+            : m_resource(resource), m_data(data), m_size(size)
+        {
+        }
+
+        ~DecodedList()
+        {
+            if (m_data) {
+                m_resource->deallocate(m_data, m_size * sizeof(bool), alignof(bool));
+            }
+        }
+
+        DecodedList(DecodedList&& other) noexcept
+            : m_resource(other.m_resource), m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0))
+        {
+        }
+
+        DecodedList(const DecodedList&) = delete;
+        DecodedList& operator=(const DecodedList&) = delete;
+
+        operator std::span<const bool>() const { return std::span<const bool>(m_data, m_size); }
+        std::size_t size() const { return m_size; }
+    };
+
+    template<typename T>
+    struct DecodedParam 
+    {
+        using type = T;
+    };
+
+    template<typename Element>
+    struct DecodedParam<std::span<const Element>> 
+    {
+        using type = DecodedList<Element>;
+    };
+
+    template<typename T>
+    using DecodedParamType = typename DecodedParam<T>::type;
+
+    // Decode one guest argument for a member function parameter of type T
+    template<typename T, bool Checked>
+    DecodedParamType<T> decodeParam(const wasmtime::component::Val& val, std::size_t index)
+    {
+        if constexpr (!std::is_same_v<DecodedParamType<T>, T>) {
+            return DecodedParamType<T>::template decode<Checked>(val);
+        } else if constexpr (Checked) {
+            return extractValue<T>(val, index);
+        } else {
+            return extractValueUnchecked<T>(val);
+        }
+    }
+
+    // Define the interface create function callback
+    using InterfaceCreateFunctionHostCallback = std::function<std::uint64_t(
+        std::uint64_t, std::uint64_t, std::string_view
+    )>;
+
+    // Define the function signature type
+    using InterfaceFunctionHostTrampoline = wasmtime::Result<std::monostate>(*)(
+        const void*,
+        wasmtime::Store::Context, 
+        const wasmtime::component::FuncType&,       
+        wasmtime::Span<wasmtime::component::Val>,
+        wasmtime::Span<wasmtime::component::Val>
+    );
+
+    // Non-owning, trivially copyable host callback: a static trampoline plus the context it dispatches with.
+    // The context is null for compile-time trampolines, or points at the stored member function pointer.
+    class InterfaceFunctionHostCallback
+    {
+    public:
+        constexpr InterfaceFunctionHostCallback() = default;
+        constexpr InterfaceFunctionHostCallback(InterfaceFunctionHostTrampoline trampoline, const void* context = nullptr)
+            : m_trampoline(trampoline), m_context(context)
+        {
+        }
+
+        wasmtime::Result<std::monostate> operator()(
+            wasmtime::Store::Context store_ctx, 
+            const wasmtime::component::FuncType& func_type,
+            wasmtime::Span<wasmtime::component::Val> args,
+            wasmtime::Span<wasmtime::component::Val> results) const
+        {
+            return m_trampoline(m_context, store_ctx, func_type, args, results);
+        }
+
+        constexpr explicit operator bool() const { return m_trampoline != nullptr; }
+
+        constexpr InterfaceFunctionHostTrampoline getTrampoline() const { return m_trampoline; }
+        constexpr const void* getContext() const { return m_context; }
+
+    private:
+        InterfaceFunctionHostTrampoline m_trampoline = nullptr;
+        const void* m_context = nullptr;
+    };
+    static_assert(std::is_trivially_copyable_v<InterfaceFunctionHostCallback>);
+
+    // Fixed-size storage for a member function pointer, so runtime callbacks can point at it without allocating
+    struct MemberFunctionStorage
+    {
+        alignas(std::max_align_t) std::byte m_bytes[4 * sizeof(void*)];
+
+        template<typename FuncPtr>
+        const FuncPtr* store(FuncPtr func_ptr)
+        {
+            static_assert(sizeof(FuncPtr) <= sizeof(m_bytes), "member function pointer does not fit MemberFunctionStorage");
+            static_assert(std::is_trivially_copyable_v<FuncPtr>);
+            return ::new (static_cast<void*>(m_bytes)) FuncPtr(func_ptr);
+        }
+    };
+
+    // Guest representation of the instance argument: a 32-bit handle table handle or a raw 64-bit host pointer
+    template<class Class>
+    using InstanceArgType = std::conditional_t<InterfaceInstanceBinding<Class>::use_handle_table, uint32_t, int64_t>;
+
+    template<class Class>
+    Class* resolveInstance(InstanceArgType<Class> instance_value)
+    {
+        if constexpr (InterfaceInstanceBinding<Class>::use_handle_table) {
+            return getInterfaceHandleTable<Class>().template resolve<Class>(instance_value);
+        } else {
+            return reinterpret_cast<Class*>(instance_value);
+        }
+    }
+
+    // Lets the first few occurrences of a failure through and then only every power of two, so a guest flooding a
+    // host function with bad instances costs an atomic increment per call rather than a log line
+    class DiagnosticRateLimiter
+    {
+    public:
+        static constexpr uint64_t BurstCount = 8;
+
+        bool shouldLog()
+        {
+            const uint64_t count = m_count.fetch_add(1, std::memory_order_relaxed) + 1;
+            return count <= BurstCount || std::has_single_bit(count);
+        }
+
+        uint64_t getCount() const { return m_count.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<uint64_t> m_count{0};
+    };
+
+    // Compile-time policy selecting how much per-call work a generated callback performs
+    enum class CallbackMode
+    {
+        Fast,       // No per-call logging or type probing, relies on validateSignature at link time
+        Diagnostic  // Checks and traces invocation, instance pointer, parameters and return value
+    };
+
+#if defined(ARIEO_WASMTIME_LINKER_DIAGNOSTIC_CALLBACKS)
+    inline constexpr CallbackMode DefaultCallbackMode = CallbackMode::Diagnostic;
+#else
+    inline constexpr CallbackMode DefaultCallbackMode = CallbackMode::Fast;
+#endif
+
+    template<typename Ret, typename Class, typename... Args, std::size_t... Is>
+    bool validateSignatureImpl(Ret(Class::*)(Args...), std::index_sequence<Is...>, const wasmtime::component::FuncType& func_type);
+
+    template<typename Ret, typename Class, typename... Args, std::size_t... Is>
+    bool validateBatchSignatureImpl(Ret(Class::*)(Args...), std::index_sequence<Is...>, const wasmtime::component::FuncType& func_type);
+
+    // Decode the guest arguments and invoke the member function using parameter pack expansion.
+    // Fast mode trusts the signature checked at link time, Diagnostic mode re-checks everything per call.
+    template<CallbackMode Mode, typename Ret, typename Class, typename... Args, std::size_t... Is>
+    inline wasmtime::Result<std::monostate> invokeCallbackImpl(
+        Ret(Class::*func_ptr)(Args...), 
+        std::index_sequence<Is...>,
+        wasmtime::Store::Context store_ctx, 
+        const wasmtime::component::FuncType& func_type,
+        wasmtime::Span<wasmtime::component::Val> args,
+        wasmtime::Span<wasmtime::component::Val> results)
+    {
+        if (!chargeHostCallFuel(store_ctx)) {
+            return wasmtime::Error("all fuel consumed by host calls");
+        }
+
+        ScopedScratchArenaFrame scratch_frame(getThreadScratchArena());
+        
+        if constexpr (Mode == CallbackMode::Diagnostic) {
+            Core::Logger::info("Generated callback invoked with {} args", args.size());
+            
+            if (args.size() < 1 + sizeof...(Args)) {
+                Core::Logger::error("Insufficient arguments: expected {}, got {}", 1 + sizeof...(Args), args.size());
+                return wasmtime::Error("insufficient arguments for host function");
+            }
+            
+            // Catches callers that skipped m_signature_validator, the fast path would read and write out of bounds
+            if (!validateSignatureImpl(func_ptr, std::index_sequence<Is...>{}, func_type) || results.size() < func_type.result_count()) {
+                Core::Logger::error("Host function called with a type that does not match its signature");
+                return wasmtime::Error("signature mismatch for host function");
+            }
+            
+            // Extract instance handle or pointer from first parameter (args[0])
+            InstanceArgType<Class> instance_value = extractValue<InstanceArgType<Class>>(args[0], 0);
+            Class* instance = resolveInstance<Class>(instance_value);
+            
+            if (!instance) {
+                Core::Logger::error("Invalid instance: {}", instance_value);
+                return wasmtime::Error("invalid instance passed to host function");
+            }
+            
+            Core::Logger::trace("Instance: 0x{:x}", instance_value);
+            
+            // Extract once, log from the decoded tuple and call with the same values
+            std::tuple<DecodedParamType<Args>...> params{decodeParam<Args, true>(args[Is + 1], Is + 1)...};
+            ((Core::Logger::trace("Param {}: type={}, value={}", Is, typeid(Args).name(), toLoggableValue(std::get<Is>(params)))), ...);
+            
+            if constexpr (std::is_void_v<HostResultType<Ret>>) {
+                invokeHostMember(instance, func_ptr, std::get<Is>(params)...);
+            } else {
+                HostResultType<Ret> result = invokeHostMember(instance, func_ptr, std::get<Is>(params)...);
+                Core::Logger::trace("Function returned: {}", toLoggableValue(result));
+                
+                if (results.size() > 0) {
+                    results[0] = createFunctionResultVal(result, func_type);
+                }
+            }
+        } else {
+            InstanceArgType<Class> instance_value = extractValueUnchecked<InstanceArgType<Class>>(args[0]);
+            Class* instance = resolveInstance<Class>(instance_value);
+            
+            if (!instance) {
+                static DiagnosticRateLimiter rate_limiter;
+                if (rate_limiter.shouldLog()) {
+                    Core::Logger::error("Invalid instance: {} ({} occurrences)", instance_value, rate_limiter.getCount());
+                }
+                return wasmtime::Error("invalid instance passed to host function");
+            }
+            
+            // Call the member function directly with parameter pack expansion
+            if constexpr (std::is_void_v<HostResultType<Ret>>) {
+                invokeHostMember(instance, func_ptr, decodeParam<Args, false>(args[Is + 1], Is + 1)...);
+            } else {
+                results[0] = createFunctionResultVal(invokeHostMember(instance, func_ptr, decodeParam<Args, false>(args[Is + 1], Is + 1)...), func_type);
+            }
+        }
+        
+        return wasmtime::Result<std::monostate>(std::monostate{});
+    }
+
+    // Helper to check one guest parameter type against the C++ parameter it feeds
+    template<typename T>
+    bool isParamTypeOf(const wasmtime::component::FuncType& func_type, std::size_t index)
+    {
+        auto param = func_type.param_nth(index);
+        return param && isValTypeOf<T>(param->second);
+    }
+
+    // Check the guest function type against the instance pointer, Args... and Ret of the member function
+    template<typename Ret, typename Class, typename... Args, std::size_t... Is>
+    bool validateSignatureImpl(Ret(Class::*)(Args...), std::index_sequence<Is...>, const wasmtime::component::FuncType& func_type)
+    {
+        if (func_type.param_count() != 1 + sizeof...(Args)) {
+            return false;
+        }
+        
+        if (!isParamTypeOf<InstanceArgType<Class>>(func_type, 0) || !(isParamTypeOf<Args>(func_type, Is + 1) && ...)) {
+            return false;
+        }
+        
+        if constexpr (std::is_void_v<HostResultType<Ret>>) {
+            return func_type.result_count() == 0;
+        } else {
+            auto result = func_type.result_nth(0);
+            return func_type.result_count() == 1 && result && isValTypeOf<HostResultType<Ret>>(*result);
+        }
+    }
+
+    template<typename FuncPtr>
+    using CallbackIndexSequence = typename tuple_index_sequence<decltype(extractParams(std::declval<FuncPtr>()))>::type;
+
+    // Define the signature validator run once per function when it is defined in a linker
+    using InterfaceFunctionSignatureValidator = bool(*)(const wasmtime::component::FuncType&);
+
+    template<typename FuncPtr>
+    bool validateSignature(const wasmtime::component::FuncType& func_type)
+    {
+        return validateSignatureImpl(FuncPtr{}, CallbackIndexSequence<FuncPtr>{}, func_type);
+    }
+
+    template<auto FuncPtr>
+    constexpr InterfaceFunctionSignatureValidator generateSignatureValidator()
+    {
+        return &validateSignature<decltype(FuncPtr)>;
+    }
+
+    template<typename FuncPtr>
+    constexpr InterfaceFunctionSignatureValidator generateSignatureValidator(const FuncPtr*)
+    {
+        return &validateSignature<FuncPtr>;
+    }
+
+    // Stateless trampoline for a member function known at compile time, the call target is a constant
+    template<auto FuncPtr, CallbackMode Mode>
+    wasmtime::Result<std::monostate> staticHostTrampoline(
+        const void*,
+        wasmtime::Store::Context store_ctx, 
+        const wasmtime::component::FuncType& func_type,
+        wasmtime::Span<wasmtime::component::Val> args,
+        wasmtime::Span<wasmtime::component::Val> results)
+    {
+        return invokeCallbackImpl<Mode>(FuncPtr, CallbackIndexSequence<decltype(FuncPtr)>{}, store_ctx, func_type, args, results);
+    }
+
+    // Shared trampoline for a member function pointer only known at runtime, read back from the context
+    template<typename FuncPtr, CallbackMode Mode>
+    wasmtime::Result<std::monostate> storedHostTrampoline(
+        const void* context,
+        wasmtime::Store::Context store_ctx, 
+        const wasmtime::component::FuncType& func_type,
+        wasmtime::Span<wasmtime::component::Val> args,
+        wasmtime::Span<wasmtime::component::Val> results)
+    {
+        return invokeCallbackImpl<Mode>(*static_cast<const FuncPtr*>(context), CallbackIndexSequence<FuncPtr>{}, store_ctx, func_type, args, results);
+    }
+
+    // Main entry point to generate callback for a compile-time member function, Mode defaults to the build-wide policy
+    template<auto FuncPtr, CallbackMode Mode = DefaultCallbackMode>
+    constexpr InterfaceFunctionHostCallback generateCallback()
+    {
+        return InterfaceFunctionHostCallback(&staticHostTrampoline<FuncPtr, Mode>);
+    }
+
+    // Generate callback for a member function pointer held in storage that outlives the callback
+    template<CallbackMode Mode = DefaultCallbackMode, typename FuncPtr>
+    InterfaceFunctionHostCallback generateCallback(const FuncPtr* func_ptr)
+    {
+        return InterfaceFunctionHostCallback(&storedHostTrampoline<FuncPtr, Mode>, func_ptr);
+    }
+
+    // Opt-in tracing variant for debugging a single function regardless of the build-wide policy
+    template<auto FuncPtr>
+    constexpr InterfaceFunctionHostCallback generateDiagnosticCallback()
+    {
+        return generateCallback<FuncPtr, CallbackMode::Diagnostic>();
+    }
+
+    template<typename FuncPtr>
+    InterfaceFunctionHostCallback generateDiagnosticCallback(const FuncPtr* func_ptr)
+    {
+        return generateCallback<CallbackMode::Diagnostic>(func_ptr);
+    }
+
+    // Suffix of the batch variant every member function gets, e.g. "set-position-batch"
+    inline constexpr std::string_view BatchFunctionSuffix = "-batch";
+
+    // Batch variant: args are (instance, list<record>) with one record of parameters per call. The list is decoded
+    // in a single host transition and non-void returns are gathered into one list<Ret> result.
+    template<CallbackMode Mode, typename Ret, typename Class, typename... Args, std::size_t... Is>
+    inline wasmtime::Result<std::monostate> invokeBatchCallbackImpl(
+        Ret(Class::*func_ptr)(Args...), 
+        std::index_sequence<Is...>,
+        wasmtime::Store::Context store_ctx, 
+        const wasmtime::component::FuncType& func_type,
+        wasmtime::Span<wasmtime::component::Val> args,
+        wasmtime::Span<wasmtime::component::Val> results)
+    {
+        if constexpr (Mode == CallbackMode::Diagnostic) {
+            if (args.size() < 2 || !validateBatchSignatureImpl(func_ptr, std::index_sequence<Is...>{}, func_type) || 
+                results.size() < func_type.result_count()) {
+                Core::Logger::error("Batch host function called with a type that does not match its signature");
+                return wasmtime::Error("signature mismatch for batch host function");
+            }
+        }
+        
+        InstanceArgType<Class> instance_value = extractValueUnchecked<InstanceArgType<Class>>(args[0]);
+        Class* instance = resolveInstance<Class>(instance_value);
+        
+        if (!instance) {
+            static DiagnosticRateLimiter rate_limiter;
+            if (rate_limiter.shouldLog()) {
+                Core::Logger::error("Invalid instance: {} ({} occurrences)", instance_value, rate_limiter.getCount());
+            }
+            return wasmtime::Error("invalid instance passed to batch host function");
+        }
+        
+        // Every element is one host call and costs as much as a separate call would
+        const wasmtime::component::List& calls = args[1].get_list();
+        if (!chargeHostCallFuel(store_ctx, calls.size())) {
+            return wasmtime::Error("all fuel consumed by host calls");
+        }
+
+        ScopedScratchArenaFrame scratch_frame(getThreadScratchArena());
+        
+        if constexpr (Mode == CallbackMode::Diagnostic) {
+            Core::Logger::info("Generated batch callback invoked with {} calls", calls.size());
+        }
+        
+        if constexpr (std::is_void_v<HostResultType<Ret>>) {
+            for (const wasmtime::component::Val& call : calls) {
+                const wasmtime::component::RecordField* fields = call.get_record().begin();
+                invokeHostMember(instance, func_ptr, decodeParam<Args, false>(fields[Is].value(), Is)...);
+            }
+        } else {
+            // The result list allocates like any list result, the component List only accepts a std::vector
+            const wasmtime::component::ValType value_type = func_type.result_nth(0)->list_element();
+            std::vector<wasmtime::component::Val> values;
+            values.reserve(calls.size());
+            for (const wasmtime::component::Val& call : calls) {
+                const wasmtime::component::RecordField* fields = call.get_record().begin();
+                values.emplace_back(createValOfType(invokeHostMember(instance, func_ptr, decodeParam<Args, false>(fields[Is].value(), Is)...), value_type));
+            }
+            results[0] = wasmtime::component::Val(wasmtime::component::List(std::move(values)));
+        }
+        
+        return wasmtime::Result<std::monostate>(std::monostate{});
+    }
+
+    // Check a batch function type: (instance, list<record { Args... }>) -> list<Ret>
+    template<typename Ret, typename Class, typename... Args, std::size_t... Is>
+    bool validateBatchSignatureImpl(Ret(Class::*)(Args...), std::index_sequence<Is...>, const wasmtime::component::FuncType& func_type)
+    {
+        if (func_type.param_count() != 2 || !isParamTypeOf<InstanceArgType<Class>>(func_type, 0)) {
+            return false;
+        }
+        
+        auto calls_param = func_type.param_nth(1);
+        if (!calls_param || !calls_param->second.is_list()) {
+            return false;
+        }
+        
+        wasmtime::component::ValType call_type = calls_param->second.list_element();
+        if (!call_type.is_record() || call_type.record_field_count() != sizeof...(Args)) {
+            return false;
+        }
+        
+        [[maybe_unused]] auto field_matches = [&call_type](std::size_t index, auto type_tag) {
+            auto field = call_type.record_field_nth(index);
+            return field && isValTypeOf<typename decltype(type_tag)::type>(field->second);
+        };
+        if (!(field_matches(Is, std::type_identity<Args>{}) && ...)) {
+            return false;
+        }
+        
+        if constexpr (std::is_void_v<HostResultType<Ret>>) {
+            return func_type.result_count() == 0;
+        } else {
+            auto result = func_type.result_nth(0);
+            return func_type.result_count() == 1 && result && result->is_list() && isValTypeOf<HostResultType<Ret>>(result->list_element());
+        }
+    }
+
+    template<typename FuncPtr>
+    bool validateBatchSignature(const wasmtime::component::FuncType& func_type)
+    {
+        return validateBatchSignatureImpl(FuncPtr{}, CallbackIndexSequence<FuncPtr>{}, func_type);
+    }
+
+    template<auto FuncPtr, CallbackMode Mode>
+    wasmtime::Result<std::monostate> staticBatchHostTrampoline(
+        const void*,
+        wasmtime::Store::Context store_ctx, 
+        const wasmtime::component::FuncType& func_type,
+        wasmtime::Span<wasmtime::component::Val> args,
+        wasmtime::Span<wasmtime::component::Val> results)
+    {
+        return invokeBatchCallbackImpl<Mode>(FuncPtr, CallbackIndexSequence<decltype(FuncPtr)>{}, store_ctx, func_type, args, results);
+    }
+
+    template<typename FuncPtr, CallbackMode Mode>
+    wasmtime::Result<std::monostate> storedBatchHostTrampoline(
+        const void* context,
+        wasmtime::Store::Context store_ctx, 
+        const wasmtime::component::FuncType& func_type,
+        wasmtime::Span<wasmtime::component::Val> args,
+        wasmtime::Span<wasmtime::component::Val> results)
+    {
+        return invokeBatchCallbackImpl<Mode>(*static_cast<const FuncPtr*>(context), CallbackIndexSequence<FuncPtr>{}, store_ctx, func_type, args, results);
+    }
+
+    // Generate the batch callback for a compile-time member function
+    template<auto FuncPtr, CallbackMode Mode = DefaultCallbackMode>
+    constexpr InterfaceFunctionHostCallback generateBatchCallback()
+    {
+        return InterfaceFunctionHostCallback(&staticBatchHostTrampoline<FuncPtr, Mode>);
+    }
+
+    // Generate the batch callback for a stored member function pointer
+    template<CallbackMode Mode = DefaultCallbackMode, typename FuncPtr>
+    InterfaceFunctionHostCallback generateBatchCallback(const FuncPtr* func_ptr)
+    {
+        return InterfaceFunctionHostCallback(&storedBatchHostTrampoline<FuncPtr, Mode>, func_ptr);
+    }
+
+    // Core wasm value type carrying a C++ scalar through typed func_wrap, void when there is no core mapping
+    template<typename T>
+    constexpr auto coreWasmTypeOf()
+    {
+        if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t>) {
+            return std::type_identity<int32_t>{};
+        }
+        else if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t> || std::is_same_v<T, char32_t>) {
+            return std::type_identity<uint32_t>{};
+        }
+        else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, int>) {
+            return std::type_identity<int32_t>{};
+        }
+        else if constexpr (std::is_same_v<T, uint32_t>) {
+            return std::type_identity<uint32_t>{};
+        }
+        else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, long long>) {
+            return std::type_identity<int64_t>{};
+        }
+        else if constexpr (std::is_same_v<T, uint64_t> || std::is_same_v<T, unsigned long long>) {
+            return std::type_identity<uint64_t>{};
+        }
+        else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+            return std::type_identity<T>{};
+        }
+        else {
+            return std::type_identity<void>{};
+        }
+    }
+
+    template<typename T>
+    using CoreWasmType = typename decltype(coreWasmTypeOf<T>())::type;
+
+    // Records read straight out of guest memory may only hold core scalars and such records, recursively. A pointer
+    // field would let the guest forge host addresses, and fields without a core mapping have no wasm32 layout that
+    // is guaranteed to match the host's.
+    template<typename T>
+    constexpr bool isCoreScalarRecord();
+
+    template<typename T>
+    constexpr bool isCoreScalarField()
+    {
+        if constexpr (is_wit_record_v<T>) {
+            return isCoreScalarRecord<T>();
+        } else {
+            return !std::is_void_v<CoreWasmType<T>>;
+        }
+    }
+
+    template<typename T, std::size_t... Is>
+    constexpr bool areCoreScalarFields(std::index_sequence<Is...>)
+    {
+        return (isCoreScalarField<ElementType<T, Is>>() && ...);
+    }
+
+    template<typename T>
+    constexpr bool isCoreScalarRecord()
+    {
+        if constexpr (is_wit_record_v<T>) {
+            return areCoreScalarFields<T>(std::make_index_sequence<element_count_v<T>>{});
+        } else {
+            return false;
+        }
+    }
+
+    // Record parameters on the core wasm path are passed as (ptr: i32) to a guest struct with the host layout
+    template<typename T>
+    inline constexpr bool is_guest_memory_record_v = isCoreScalarRecord<T>();
+
+    // Elements a std::span<const E> may alias in guest memory without copying: every bit pattern the guest can write
+    // has to be a valid E. That admits non-bool core scalars, std::byte and core scalar records built from them,
+    // but no bool (only 0 and 1 are valid) and no pointer, which a guest could forge.
+    template<typename T>
+    constexpr bool isAliasableGuestElement();
+
+    template<typename T, std::size_t... Is>
+    constexpr bool areAliasableGuestFields(std::index_sequence<Is...>)
+    {
+        return (isAliasableGuestElement<ElementType<T, Is>>() && ...);
+    }
+
+    template<typename T>
+    constexpr bool isAliasableGuestElement()
+    {
+        if constexpr (is_wit_record_v<T>) {
+            return isCoreScalarRecord<T>() && areAliasableGuestFields<T>(std::make_index_sequence<element_count_v<T>>{});
+        } else {
+            return std::is_same_v<T, std::byte> || (!std::is_same_v<T, bool> && !std::is_void_v<CoreWasmType<T>>);
+        }
+    }
+
+    // Parameter types satisfied by a view into guest linear memory, passed by core wasm as (ptr: i32, len: i32).
+    // A view is only valid for the duration of the host call, the guest memory may grow or be reused afterwards.
+    template<typename T>
+    struct GuestMemoryView : std::false_type {};
+
+    template<>
+    struct GuestMemoryView<std::string_view> : std::true_type 
+    {
+        using element_type = const char;
+    };
+
+    template<typename Element>
+    struct GuestMemoryView<std::span<const Element>> : std::bool_constant<isAliasableGuestElement<Element>()> 
+    {
+        using element_type = const Element;
+    };
+
+    template<typename T>
+    inline constexpr bool is_guest_memory_view_v = GuestMemoryView<T>::value;
+
+
+    // Guest bytes are copied out rather than aliased, bools are normalized so any non-zero byte reads as true and
+    // records are read field by field at the host offset of each field
+    template<typename T>
+    T readGuestField(const std::byte* field)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            return *field != std::byte{0};
+        } else if constexpr (is_guest_memory_record_v<T>) {
+            T value{};
+            const std::byte* base = reinterpret_cast<const std::byte*>(&value);
+            std::apply([field, base](auto&... members) {
+                ((members = readGuestField<std::remove_cvref_t<decltype(members)>>(
+                    field + (reinterpret_cast<const std::byte*>(&members) - base)
+                )), ...);
+            }, tieFields(value));
+            return value;
+        } else {
+            T value;
+            std::memcpy(&value, field, sizeof(T));
+            return value;
+        }
+    }
+
+    template<typename Ret, typename... Args>
+    inline constexpr bool is_core_wasm_signature_v = 
+        (std::is_void_v<HostResultType<Ret>> || !std::is_void_v<CoreWasmType<HostResultType<Ret>>>) && 
+        ((!std::is_void_v<CoreWasmType<Args>> || is_guest_memory_view_v<Args> || is_guest_memory_record_v<Args>) && ...);
+
+    // Core wasm parameters one C++ parameter is flattened to
+    template<typename T>
+    using CoreWasmParams = std::conditional_t<
+        is_guest_memory_view_v<T>, 
+        std::tuple<int32_t, int32_t>, 
+        std::conditional_t<is_guest_memory_record_v<T>, std::tuple<int32_t>, std::tuple<CoreWasmType<T>>>
+    >;
+
+    template<typename... Args>
+    using CoreWasmParamTuple = decltype(std::tuple_cat(std::declval<CoreWasmParams<Args>>()...));
+
+    // Index of the first flattened core parameter of every C++ parameter
+    template<typename... Args>
+    constexpr std::array<std::size_t, sizeof...(Args)> coreWasmParamOffsets()
+    {
+        std::array<std::size_t, sizeof...(Args)> offsets{};
+        std::size_t offset = 0;
+        std::size_t index = 0;
+        ((offsets[index++] = offset, offset += std::tuple_size_v<CoreWasmParams<Args>>), ...);
+        return offsets;
+    }
+
+    // Decode one C++ parameter from the flattened core values, views are bounds and alignment checked
+    template<typename T, std::size_t Offset, typename CoreParamTuple>
+    T decodeCoreParam(const CoreParamTuple& core_params, wasmtime::Span<uint8_t> memory, bool& in_bounds)
+    {
+        if constexpr (is_guest_memory_view_v<T>) {
+            using Element = typename GuestMemoryView<T>::element_type;
+            const std::size_t offset = static_cast<uint32_t>(std::get<Offset>(core_params));
+            const std::size_t count = static_cast<uint32_t>(std::get<Offset + 1>(core_params));
+            if (offset > memory.size() || count > (memory.size() - offset) / sizeof(Element) || offset % alignof(Element) != 0) {
+                in_bounds = false;
+                return T{};
+            }
+            return T(reinterpret_cast<Element*>(memory.data() + offset), count);
+        } else if constexpr (is_guest_memory_record_v<T>) {
+            const std::size_t offset = static_cast<uint32_t>(std::get<Offset>(core_params));
+            if (offset > memory.size() || sizeof(T) > memory.size() - offset) {
+                in_bounds = false;
+                return T{};
             }
+            return readGuestField<T>(reinterpret_cast<const std::byte*>(memory.data() + offset));
+        } else {
+            return static_cast<T>(std::get<Offset>(core_params));
         }
-        return T{};
     }
 
-    // Helper to convert C++ return value to WASM Val type
-    template<typename Ret>
-    wasmtime::component::Val createResultVal(const Ret& result)
+    // Define the core wasm function definer: registers one member function on a core linker as a typed host function
+    using InterfaceFunctionCoreDefiner = wasmtime::Result<std::monostate>(*)(
+        wasmtime::Linker&,
+        std::string_view,
+        std::string_view,
+        const void*,
+        InterfaceFunctionCallStats*,
+        InterfaceFunctionAffinity
+    );
+
+    // Wrap the member function in a typed lambda, so func_wrap passes arguments as raw core values without Val decoding
+    template<typename Ret, typename Class, typename... Args, typename... CoreParams, std::size_t... Is>
+    wasmtime::Result<std::monostate> defineCoreFunctionImpl(
+        wasmtime::Linker& linker, 
+        std::string_view module_name, 
+        std::string_view function_name, 
+        Ret(Class::*func_ptr)(Args...),
+        InterfaceFunctionCallStats* call_stats,
+        InterfaceFunctionAffinity affinity,
+        std::tuple<CoreParams...>*,
+        std::index_sequence<Is...>)
     {
-        if constexpr (std::is_same_v<Ret, int32_t> || std::is_same_v<Ret, int>) {
-            return wasmtime::component::Val(static_cast<int32_t>(result));
-        }
-        else if constexpr (std::is_same_v<Ret, int64_t> || std::is_same_v<Ret, long long>) {
-            return wasmtime::component::Val(static_cast<int64_t>(result));
+        using CoreRet = std::conditional_t<std::is_void_v<HostResultType<Ret>>, std::monostate, CoreWasmType<HostResultType<Ret>>>;
+        constexpr bool has_memory_views = ((is_guest_memory_view_v<Args> || is_guest_memory_record_v<Args>) || ...);
+        
+        return linker.func_wrap(module_name, function_name,
+            [func_ptr, call_stats, affinity, module_name, function_name](wasmtime::Caller caller, CoreWasmType<InstanceArgType<Class>> instance_value, CoreParams... core_params) -> wasmtime::Result<CoreRet, wasmtime::Trap> {
+                ScopedProfilerZone profiler_zone(module_name, function_name);
+                ScopedCallStatsTimer call_stats_timer(call_stats);
+                ScopedHostCallAffinity affinity_scope(affinity);
+                if (!chargeHostCallFuel(caller.context())) {
+                    return wasmtime::Trap("all fuel consumed by host calls");
+                }
+                
+                Class* instance = resolveInstance<Class>(static_cast<InstanceArgType<Class>>(instance_value));
+                if (!instance) {
+                    return wasmtime::Trap("Invalid instance");
+                }
+                
+                // The memory export is only looked up for signatures that take views
+                wasmtime::Span<uint8_t> memory;
+                if constexpr (has_memory_views) {
+                    auto memory_export = caller.get_export("memory");
+                    if (!memory_export || !std::holds_alternative<wasmtime::Memory>(*memory_export)) {
+                        return wasmtime::Trap("Guest does not export memory");
+                    }
+                    memory = std::get<wasmtime::Memory>(*memory_export).data(caller.context());
+                }
+                
+                std::tuple<CoreParams...> flattened{core_params...};
+                bool in_bounds = true;
+                std::tuple<Args...> params{decodeCoreParam<Args, coreWasmParamOffsets<Args...>()[Is]>(flattened, memory, in_bounds)...};
+                if (!in_bounds) {
+                    return wasmtime::Trap("Guest memory view out of bounds");
+                }
+                
+                if constexpr (std::is_void_v<HostResultType<Ret>>) {
+                    invokeHostMember(instance, func_ptr, std::get<Is>(params)...);
+                    return std::monostate{};
+                } else {
+                    return static_cast<CoreRet>(invokeHostMember(instance, func_ptr, std::get<Is>(params)...));
+                }
+            }
+        );
+    }
+
+    template<typename Ret, typename Class, typename... Args>
+    wasmtime::Result<std::monostate> defineCoreFunctionImpl(
+        wasmtime::Linker& linker, 
+        std::string_view module_name, 
+        std::string_view function_name, 
+        Ret(Class::*func_ptr)(Args...),
+        InterfaceFunctionCallStats* call_stats,
+        InterfaceFunctionAffinity affinity)
+    {
+        return defineCoreFunctionImpl(
+            linker, module_name, function_name, func_ptr, call_stats, affinity,
+            static_cast<CoreWasmParamTuple<Args...>*>(nullptr), 
+            std::index_sequence_for<Args...>{}
+        );
+    }
+
+    template<auto FuncPtr>
+    wasmtime::Result<std::monostate> staticCoreDefiner(
+        wasmtime::Linker& linker, 
+        std::string_view module_name, 
+        std::string_view function_name, 
+        const void*, 
+        InterfaceFunctionCallStats* call_stats, 
+        InterfaceFunctionAffinity affinity)
+    {
+        return defineCoreFunctionImpl(linker, module_name, function_name, FuncPtr, call_stats, affinity);
+    }
+
+    template<typename FuncPtr>
+    wasmtime::Result<std::monostate> storedCoreDefiner(
+        wasmtime::Linker& linker, 
+        std::string_view module_name, 
+        std::string_view function_name, 
+        const void* context, 
+        InterfaceFunctionCallStats* call_stats, 
+        InterfaceFunctionAffinity affinity)
+    {
+        return defineCoreFunctionImpl(linker, module_name, function_name, *static_cast<const FuncPtr*>(context), call_stats, affinity);
+    }
+
+    template<typename Ret, typename Class, typename... Args>
+    constexpr bool isCoreWasmSignature(Ret(Class::*)(Args...))
+    {
+        return is_core_wasm_signature_v<Ret, Args...>;
+    }
+
+    // Core wasm definer for a compile-time member function, null when the signature has non-scalar types
+    template<auto FuncPtr>
+    constexpr InterfaceFunctionCoreDefiner generateCoreDefiner()
+    {
+        if constexpr (isCoreWasmSignature(FuncPtr)) {
+            return &staticCoreDefiner<FuncPtr>;
+        } else {
+            return nullptr;
         }
-        else if constexpr (std::is_same_v<Ret, uint64_t> || std::is_same_v<Ret, unsigned long long>) {
-            return wasmtime::component::Val(static_cast<uint64_t>(result));
+    }
+
+    // Core wasm definer for a stored member function pointer, the context passed at define time is the storage
+    template<typename FuncPtr>
+    constexpr InterfaceFunctionCoreDefiner generateCoreDefiner(const FuncPtr*)
+    {
+        if constexpr (isCoreWasmSignature(FuncPtr{})) {
+            return &storedCoreDefiner<FuncPtr>;
+        } else {
+            return nullptr;
         }
-        else if constexpr (std::is_same_v<Ret, float>) {
-            return wasmtime::component::Val(result);
+    }
+
+    // Void member functions taking only scalars and core-scalar records (see is_guest_memory_record_v) can be
+    // queued as fire-and-forget commands. A command payload is laid out like the C struct { instance; Args...; }
+    // with natural alignment, the same layout a wasm32 guest compiler gives that struct, so the guest writes it with
+    // plain stores. Fields are read back with readGuestField.
+    template<typename Ret, typename... Args>
+    inline constexpr bool is_command_signature_v = 
+        std::is_void_v<Ret> && ((!std::is_void_v<CoreWasmType<Args>> || is_guest_memory_record_v<Args>) && ...);
+
+    // Offset of every payload field, the last entry is the payload size
+    template<typename... Fields>
+    constexpr std::array<std::size_t, sizeof...(Fields) + 1> commandPayloadLayout()
+    {
+        std::array<std::size_t, sizeof...(Fields) + 1> layout{};
+        std::size_t offset = 0;
+        std::size_t index = 0;
+        ((offset = (offset + alignof(Fields) - 1) / alignof(Fields) * alignof(Fields), layout[index++] = offset, offset += sizeof(Fields)), ...);
+        layout[index] = offset;
+        return layout;
+    }
+
+    // Define the command decoder: dispatches one queued command payload, false when it is truncated or the
+    // instance does not resolve
+    using InterfaceFunctionCommandDecoder = bool(*)(const void*, const std::byte*, std::size_t);
+
+    template<typename Ret, typename Class, typename... Args, std::size_t... Is>
+    bool decodeCommandImpl(Ret(Class::*func_ptr)(Args...), std::index_sequence<Is...>, const std::byte* payload, std::size_t payload_size)
+    {
+        using InstanceField = CoreWasmType<InstanceArgType<Class>>;
+        constexpr auto layout = commandPayloadLayout<InstanceField, Args...>();
+        if (payload_size < layout.back()) {
+            return false;
         }
-        else if constexpr (std::is_same_v<Ret, double>) {
-            return wasmtime::component::Val(result);
+        
+        Class* instance = resolveInstance<Class>(static_cast<InstanceArgType<Class>>(readGuestField<InstanceField>(payload + layout[0])));
+        if (!instance) {
+            return false;
         }
-        return wasmtime::component::Val(static_cast<int32_t>(0));
+        
+        // Through invokeHostMember so the affinity set by the drain routes pinned commands to the main thread
+        invokeHostMember(instance, func_ptr, readGuestField<Args>(payload + layout[Is + 1])...);
+        return true;
     }
 
-    // Define the interface create function callback
-    using InterfaceCreateFunctionHostCallback = std::function<std::uint64_t(
-        std::uint64_t, std::uint64_t, std::string_view
-    )>;
+    template<auto FuncPtr>
+    bool staticCommandDecoder(const void*, const std::byte* payload, std::size_t payload_size)
+    {
+        return decodeCommandImpl(FuncPtr, CallbackIndexSequence<decltype(FuncPtr)>{}, payload, payload_size);
+    }
 
-    // Define the function signature type
-    using InterfaceFunctionHostCallback = std::function<wasmtime::Result<std::monostate>(
-        wasmtime::Store::Context, 
-        const wasmtime::component::FuncType&,       
-        wasmtime::Span<wasmtime::component::Val>,
-        wasmtime::Span<wasmtime::component::Val>
-    )>;
+    template<typename FuncPtr>
+    bool storedCommandDecoder(const void* context, const std::byte* payload, std::size_t payload_size)
+    {
+        return decodeCommandImpl(*static_cast<const FuncPtr*>(context), CallbackIndexSequence<FuncPtr>{}, payload, payload_size);
+    }
 
-    // Generate callback using parameter pack expansion
-    template<typename FuncPtr, typename Ret, typename Class, typename... Args, std::size_t... Is>
-    InterfaceFunctionHostCallback generateCallbackImpl(FuncPtr func_ptr, Ret(Class::*)(Args...), std::index_sequence<Is...>)
+    template<typename Ret, typename Class, typename... Args>
+    constexpr bool isCommandSignature(Ret(Class::*)(Args...))
     {
-        return [func_ptr](
-            wasmtime::Store::Context store_ctx, 
-            const wasmtime::component::FuncType& func_type,
-            wasmtime::Span<wasmtime::component::Val> args,
-            wasmtime::Span<wasmtime::component::Val> results) -> wasmtime::Result<std::monostate> {
-            
-            Core::Logger::info("Generated callback invoked with {} args", args.size());
-            
-            // Extract instance pointer from first parameter (args[0]) as int64
-            if (args.size() < 1 + sizeof...(Args)) {
-                Core::Logger::error("Insufficient arguments: expected {}, got {}", 1 + sizeof...(Args), args.size());
-                return wasmtime::Result<std::monostate>(std::monostate{});
-            }
-            
-            int64_t instance_ptr_value = extractValue<int64_t>(args[0], 0);
-            Class* instance = reinterpret_cast<Class*>(instance_ptr_value);
-            
-            if (!instance) {
-                Core::Logger::error("Invalid instance pointer: {}", instance_ptr_value);
-                return wasmtime::Result<std::monostate>(std::monostate{});
-            }
-            
-            Core::Logger::trace("Instance pointer: 0x{:x}", instance_ptr_value);
-            
-            // Log extracted parameters directly
-            ((Core::Logger::trace("Param {}: type={}, value={}", Is, typeid(Args).name(), extractValue<Args>(args[Is + 1], Is + 1))), ...);
-            
-            // Call the member function directly with parameter pack expansion
-            if constexpr (std::is_void_v<Ret>) {
-                (instance->*func_ptr)(extractValue<Args>(args[Is + 1], Is + 1)...);
-            } else {
-                Ret result = (instance->*func_ptr)(extractValue<Args>(args[Is + 1], Is + 1)...);
-                Core::Logger::trace("Function returned: {}", result);
-                
-                // Store result in results span
-                if (results.size() > 0) {
-                    results[0] = createResultVal(result);
-                }
-            }
-            
-            return wasmtime::Result<std::monostate>(std::monostate{});
-        };
+        return is_command_signature_v<Ret, Args...>;
+    }
+
+    // Command decoder for a compile-time member function, null when the function cannot be queued
+    template<auto FuncPtr>
+    constexpr InterfaceFunctionCommandDecoder generateCommandDecoder()
+    {
+        if constexpr (isCommandSignature(FuncPtr)) {
+            return &staticCommandDecoder<FuncPtr>;
+        } else {
+            return nullptr;
+        }
     }
 
-    // Main entry point to generate callback
+    // Command decoder for a stored member function pointer, the context passed when decoding is the storage
     template<typename FuncPtr>
-    InterfaceFunctionHostCallback generateCallback(FuncPtr func_ptr)
+    constexpr InterfaceFunctionCommandDecoder generateCommandDecoder(const FuncPtr*)
     {
-        using FuncType = std::remove_pointer_t<FuncPtr>;
-        using IndexSeq = typename tuple_index_sequence<decltype(extractParams(FuncType{}))>::type;
-        return generateCallbackImpl(func_ptr, FuncType{}, IndexSeq{});
+        if constexpr (isCommandSignature(FuncPtr{})) {
+            return &storedCommandDecoder<FuncPtr>;
+        } else {
+            return nullptr;
+        }
     }
 
-    
 }
 
 namespace Arieo::Lib::WasmtimeLinker 
 {
+    // m_host_callback and m_batch_host_callback are unchecked in Fast builds: they trust that the guest type passed
+    // m_signature_validator (m_batch_signature_validator) and read args and write results[0] without bounds checks.
+    // The define* helpers validate before adding them. Code adding them to a linker itself must validate the
+    // imported type first, or wrap them with makeCheckedHostCallback. Diagnostic builds re-validate every call.
     struct InterfaceFunctionExportInfo
     {
         const char* m_function_name;
         uint64_t m_function_id;
         uint64_t m_function_checksum;
         InterfaceFunctionHostCallback m_host_callback;
+        InterfaceFunctionSignatureValidator m_signature_validator;
+        InterfaceFunctionHostCallback m_batch_host_callback;
+        InterfaceFunctionSignatureValidator m_batch_signature_validator;
+        InterfaceFunctionCoreDefiner m_core_definer;    // Null when the signature cannot be expressed in core wasm
+        InterfaceFunctionCommandDecoder m_command_decoder;  // Null when the function cannot be queued on a command ring
+        InterfaceFunctionCallStats* m_call_stats;       // Present regardless of ARIEO_WASMTIME_LINKER_CALL_STATS to keep the layout stable
+        InterfaceFunctionAffinity m_affinity;           // Thread the member function must run on, see MainThreadDispatchQueue
     };
 
     struct InterfaceExportInfo
@@ -170,50 +1497,197 @@ namespace Arieo::Lib::WasmtimeLinker
         uint64_t m_interaface_id;
         uint64_t m_interface_checksum;
         std::size_t m_interface_type_hash;
-        InterfaceFunctionExportInfo* m_member_function_array;
+        const InterfaceFunctionExportInfo* m_member_function_array;
         size_t m_member_function_count;
     };
 
+    // m_interface_array is sorted by m_interaface_id and every m_member_function_array by m_function_id,
+    // so imports resolve with findInterfaceExportInfo/findFunctionExportInfo instead of a linear scan
     struct LinkerExportInfo
     {
-        InterfaceExportInfo* m_interface_array;
+        const InterfaceExportInfo* m_interface_array;
         size_t m_interface_count;
     };
 
+    constexpr uint64_t getExportInfoId(const InterfaceFunctionExportInfo& function_info) { return function_info.m_function_id; }
+    constexpr uint64_t getExportInfoId(const InterfaceExportInfo& interface_info) { return interface_info.m_interaface_id; }
+
+    // Sort export entries by id, constexpr so compile-time tables can be emitted pre-sorted
+    template<typename ExportInfo, std::size_t N>
+    constexpr std::array<ExportInfo, N> sortExportInfoById(std::array<ExportInfo, N> export_info_array)
+    {
+        std::sort(export_info_array.begin(), export_info_array.end(), 
+            [](const ExportInfo& lhs, const ExportInfo& rhs) { return getExportInfoId(lhs) < getExportInfoId(rhs); }
+        );
+        return export_info_array;
+    }
+
+    template<typename ExportInfo>
+    constexpr const ExportInfo* findExportInfoById(const ExportInfo* export_info_array, std::size_t count, uint64_t id)
+    {
+        const ExportInfo* end = export_info_array + count;
+        const ExportInfo* found = std::lower_bound(export_info_array, end, id, 
+            [](const ExportInfo& export_info, uint64_t value) { return getExportInfoId(export_info) < value; }
+        );
+        return found != end && getExportInfoId(*found) == id ? found : nullptr;
+    }
+
+    // Binary search for an interface by id, null when the linker export info does not provide it
+    constexpr const InterfaceExportInfo* findInterfaceExportInfo(const LinkerExportInfo& linker_export_info, uint64_t interface_id)
+    {
+        return findExportInfoById(linker_export_info.m_interface_array, linker_export_info.m_interface_count, interface_id);
+    }
+
+    // Binary search for a member function by id within one interface
+    constexpr const InterfaceFunctionExportInfo* findFunctionExportInfo(const InterfaceExportInfo& interface_info, uint64_t function_id)
+    {
+        return findExportInfoById(interface_info.m_member_function_array, interface_info.m_member_function_count, function_id);
+    }
+
+    constexpr const InterfaceFunctionExportInfo* findFunctionExportInfo(const LinkerExportInfo& linker_export_info, uint64_t interface_id, uint64_t function_id)
+    {
+        const InterfaceExportInfo* interface_info = findInterfaceExportInfo(linker_export_info, interface_id);
+        return interface_info ? findFunctionExportInfo(*interface_info, function_id) : nullptr;
+    }
+
+    // Compile-time export entry for a member function given as a constant. Every callback is a stateless
+    // trampoline, so tables of these can be declared constexpr and placed in read-only data.
+    // Pass the entry arrays through sortExportInfoById before building the interface and linker tables.
+    template<auto FuncPtr>
+    constexpr InterfaceFunctionExportInfo makeInterfaceFunctionExportInfo(
+        const char* function_name, 
+        uint64_t function_id, 
+        uint64_t function_checksum, 
+        InterfaceFunctionCallStats* call_stats = nullptr,
+        InterfaceFunctionAffinity affinity = InterfaceFunctionAffinity::Any)
+    {
+        return InterfaceFunctionExportInfo
+        {
+            function_name,
+            function_id,
+            function_checksum,
+            generateCallback<FuncPtr>(),
+            generateSignatureValidator<FuncPtr>(),
+            generateBatchCallback<FuncPtr>(),
+            &validateBatchSignature<decltype(FuncPtr)>,
+            generateCoreDefiner<FuncPtr>(),
+            generateCommandDecoder<FuncPtr>(),
+            call_stats,
+            affinity
+        };
+    }
+
+    template<std::size_t N>
+    constexpr InterfaceExportInfo makeInterfaceExportInfo(
+        const char* interface_name, 
+        uint64_t interface_id, 
+        uint64_t interface_checksum, 
+        std::size_t interface_type_hash,
+        const std::array<InterfaceFunctionExportInfo, N>& function_info_array)
+    {
+        return InterfaceExportInfo{interface_name, interface_id, interface_checksum, interface_type_hash, function_info_array.data(), N};
+    }
+
+    template<std::size_t N>
+    constexpr LinkerExportInfo makeLinkerExportInfo(const std::array<InterfaceExportInfo, N>& interface_export_info_array)
+    {
+        return LinkerExportInfo{interface_export_info_array.data(), N};
+    }
+
+    // Interface name as a null-terminated char array in read-only data, for InterfaceInfo<T> that computes it at compile time
+    template<class T>
+    struct ConstantInterfaceName
+    {
+        static constexpr std::size_t size = Arieo::Base::InterfaceInfo<T>::getWitFullInterfaceName().size();
+        static constexpr std::array<char, size + 1> value = []() {
+            std::array<char, size + 1> chars{};
+            const auto name = Arieo::Base::InterfaceInfo<T>::getWitFullInterfaceName();
+            for (std::size_t i = 0; i < size; ++i) {
+                chars[i] = name[i];
+            }
+            return chars;
+        }();
+    };
+
+    template<class T>
+    concept HasConstantInterfaceName = requires {
+        typename std::integral_constant<std::size_t, Arieo::Base::InterfaceInfo<T>::getWitFullInterfaceName().size()>;
+    };
+
+    // Interface name storage, falls back to a string built once at runtime
+    template<class T>
+    const char* getInterfaceNameStorage()
+    {
+        if constexpr (HasConstantInterfaceName<T>) {
+            return ConstantInterfaceName<T>::value.data();
+        } else {
+            static const std::string interface_name = Arieo::Base::InterfaceInfo<T>::getWitFullInterfaceName();
+            return interface_name.data();
+        }
+    }
+
     template<class T>
     class InterfaceExportInfoRegister
     {
     public:
+        // Built exactly once, concurrent first callers wait on the function-local static initialization
+        static const InterfaceExportInfo& getInterfaceExportInfo()
+        {
+            static const InterfaceExportInfo interface_export_info = buildInterfaceExportInfo();
+            return interface_export_info;
+        }
+
         static void fillInterfaceExportInfo(InterfaceExportInfo& interface_export_info)
         {
-            static std::string interface_name = Arieo::Base::InterfaceInfo<T>::getWitFullInterfaceName();
+            interface_export_info = getInterfaceExportInfo();
+        }
+
+    private:
+        static InterfaceExportInfo buildInterfaceExportInfo()
+        {
+            InterfaceExportInfo interface_export_info{};
 
             static std::array<InterfaceFunctionExportInfo, Arieo::Base::InterfaceInfo<T>::getMemberFunctionCount()> function_info_array;
             static std::array<std::string, Arieo::Base::InterfaceInfo<T>::getMemberFunctionCount()> function_name_array;
+            // Only referenced from the lambda below, which GCC does not count as a use of a static local
+            [[maybe_unused]] static std::array<MemberFunctionStorage, Arieo::Base::InterfaceInfo<T>::getMemberFunctionCount()> function_ptr_array;
+            static std::array<InterfaceFunctionCallStats, Arieo::Base::InterfaceInfo<T>::getMemberFunctionCount()> function_stats_array;
 
             size_t function_index = 0;
             Arieo::Base::InterfaceInfo<T>::iteratorMemberFunctions(
-                [&function_index](auto func_ptr, std::string_view func_name, std::string_view wit_func_name, std::uint64_t function_id, std::uint64_t function_checksum) 
+                [&function_index](auto func_ptr, [[maybe_unused]] std::string_view func_name, std::string_view wit_func_name, std::uint64_t function_id, std::uint64_t function_checksum) 
                 {
                     function_name_array[function_index] = std::string(wit_func_name);
+                    const auto* stored_func_ptr = function_ptr_array[function_index].store(func_ptr);
                     function_info_array[function_index] = 
                     {
                         function_name_array[function_index].data(),
                         function_id,
                         function_checksum,
-                        generateCallback(func_ptr) // Placeholder for callback
+                        generateCallback(stored_func_ptr),
+                        generateSignatureValidator(stored_func_ptr),
+                        generateBatchCallback(stored_func_ptr),
+                        &validateBatchSignature<std::remove_cvref_t<decltype(func_ptr)>>,
+                        generateCoreDefiner(stored_func_ptr),
+                        generateCommandDecoder(stored_func_ptr),
+                        &function_stats_array[function_index],
+                        InterfaceThreadAffinity<T>::getFunctionAffinity(wit_func_name)
                     };
                     ++function_index;
                 }
             );
+            std::sort(function_info_array.begin(), function_info_array.end(), 
+                [](const InterfaceFunctionExportInfo& lhs, const InterfaceFunctionExportInfo& rhs) { return lhs.m_function_id < rhs.m_function_id; }
+            );
 
-            interface_export_info.m_interface_name = interface_name.data();
+            interface_export_info.m_interface_name = getInterfaceNameStorage<T>();
             interface_export_info.m_interaface_id = Arieo::Base::InterfaceInfo<T>::getInterfaceId();
             interface_export_info.m_interface_checksum = Arieo::Base::InterfaceInfo<T>::getInterfaceChecksum();
             interface_export_info.m_interface_type_hash = Arieo::Base::ct::genCrc32StringID(typeid(T).name());
             
             interface_export_info.m_member_function_array = function_info_array.data();
             interface_export_info.m_member_function_count = function_info_array.size();
+            return interface_export_info;
         }
     };
 
@@ -221,7 +1695,15 @@ namespace Arieo::Lib::WasmtimeLinker
     class LinkerExportInfoRegister
     {
     public:
+        // Returns the cached table, it is filled on the first call only and safe to call from any thread
         static LinkerExportInfo* generateLinkerExportInfo()
+        {
+            static LinkerExportInfo* linker_export_info = buildLinkerExportInfo();
+            return linker_export_info;
+        }
+
+    private:
+        static LinkerExportInfo* buildLinkerExportInfo()
         {
             static std::array<InterfaceExportInfo, sizeof...(Interfaces)> m_interface_export_info_array;
             static LinkerExportInfo m_linker_export_info;
@@ -231,6 +1713,9 @@ namespace Arieo::Lib::WasmtimeLinker
             (void)std::initializer_list<int>{
                 (InterfaceExportInfoRegister<Interfaces>::fillInterfaceExportInfo(m_interface_export_info_array[index++]), 0)...
             };
+            std::sort(m_interface_export_info_array.begin(), m_interface_export_info_array.end(), 
+                [](const InterfaceExportInfo& lhs, const InterfaceExportInfo& rhs) { return lhs.m_interaface_id < rhs.m_interaface_id; }
+            );
             
             m_linker_export_info.m_interface_array = m_interface_export_info_array.data();
             m_linker_export_info.m_interface_count = sizeof...(Interfaces);
@@ -238,7 +1723,349 @@ namespace Arieo::Lib::WasmtimeLinker
         }
     };
 
-    typedef LinkerExportInfo* (*DLLExportLinkInterfacesFn)(std::uint64_t version_checksum);
+    // Callback handed to the linker, wrapped with call timing and profiler zones only when either is compiled in
+#if defined(ARIEO_WASMTIME_LINKER_CALL_STATS) || defined(ARIEO_WASMTIME_LINKER_PROFILER_ZONES)
+    inline auto makeLinkerCallback(
+        InterfaceFunctionHostCallback callback, 
+        InterfaceFunctionCallStats* call_stats, 
+        std::string_view interface_name, 
+        std::string_view function_name)
+    {
+        return [callback, call_stats, interface_name, function_name](
+            wasmtime::Store::Context store_ctx, 
+            const wasmtime::component::FuncType& func_type,
+            wasmtime::Span<wasmtime::component::Val> args,
+            wasmtime::Span<wasmtime::component::Val> results) -> wasmtime::Result<std::monostate> {
+            ScopedProfilerZone profiler_zone(interface_name, function_name);
+            ScopedCallStatsTimer call_stats_timer(call_stats);
+            return callback(store_ctx, func_type, args, results);
+        };
+    }
+#else
+    inline InterfaceFunctionHostCallback makeLinkerCallback(
+        InterfaceFunctionHostCallback callback, InterfaceFunctionCallStats*, std::string_view, std::string_view)
+    {
+        return callback;
+    }
+#endif
+
+    // Walk every function in the linker export info and log its call count, time and latency histogram
+    inline void dumpLinkerExportCallStats(const LinkerExportInfo& linker_export_info)
+    {
+#if defined(ARIEO_WASMTIME_LINKER_CALL_STATS)
+        for (size_t i = 0; i < linker_export_info.m_interface_count; ++i) {
+            const InterfaceExportInfo& interface_info = linker_export_info.m_interface_array[i];
+            for (size_t j = 0; j < interface_info.m_member_function_count; ++j) {
+                const InterfaceFunctionExportInfo& function_info = interface_info.m_member_function_array[j];
+                if (!function_info.m_call_stats) {
+                    continue;
+                }
+                
+                const uint64_t call_count = function_info.m_call_stats->m_call_count.load(std::memory_order_relaxed);
+                if (call_count == 0) {
+                    continue;
+                }
+                
+                const uint64_t total_nanoseconds = function_info.m_call_stats->m_total_nanoseconds.load(std::memory_order_relaxed);
+                Core::Logger::info("{}.{}: calls={}, total={}ns, avg={}ns", 
+                    interface_info.m_interface_name, function_info.m_function_name, 
+                    call_count, total_nanoseconds, total_nanoseconds / call_count
+                );
+                
+                for (size_t bucket = 0; bucket < InterfaceFunctionCallStats::HistogramBucketCount; ++bucket) {
+                    const uint64_t bucket_count = function_info.m_call_stats->m_latency_histogram[bucket].load(std::memory_order_relaxed);
+                    if (bucket_count != 0) {
+                        Core::Logger::info("    <{}ns: {}", uint64_t(1) << bucket, bucket_count);
+                    }
+                }
+            }
+        }
+#else
+        (void)linker_export_info;
+        Core::Logger::info("Call stats are disabled, define ARIEO_WASMTIME_LINKER_CALL_STATS to record them");
+#endif
+    }
+
+    inline void resetLinkerExportCallStats(const LinkerExportInfo& linker_export_info)
+    {
+        for (size_t i = 0; i < linker_export_info.m_interface_count; ++i) {
+            const InterfaceExportInfo& interface_info = linker_export_info.m_interface_array[i];
+            for (size_t j = 0; j < interface_info.m_member_function_count; ++j) {
+                if (interface_info.m_member_function_array[j].m_call_stats) {
+                    interface_info.m_member_function_array[j].m_call_stats->reset();
+                }
+            }
+        }
+    }
+
+    // Look up the type of a function the component imports from the given interface instance
+    inline std::optional<wasmtime::component::FuncType> findImportedFuncType(
+        const wasmtime::Engine& engine,
+        const wasmtime::component::Component& component,
+        std::string_view interface_name,
+        std::string_view function_name)
+    {
+        auto interface_item = component.type().import_get(engine, interface_name);
+        if (!interface_item || !interface_item->is_component_instance()) {
+            return std::nullopt;
+        }
+        
+        auto function_item = interface_item->component_instance().export_get(engine, function_name);
+        if (!function_item || !function_item->is_component_func()) {
+            return std::nullopt;
+        }
+        return function_item->component_func();
+    }
+
+    // Add a linker callback, marking the call with the function's affinity when it is pinned to a thread
+    template<typename LinkerCallback>
+    wasmtime::Result<std::monostate> addComponentLinkerCallback(
+        wasmtime::component::LinkerInstance& linker_instance,
+        const InterfaceExportInfo& interface_info,
+        std::string_view function_name,
+        InterfaceFunctionAffinity affinity,
+        LinkerCallback linker_callback)
+    {
+        // Only pinned functions pay for marking the call, Any is the thread's default affinity
+        auto result = affinity == InterfaceFunctionAffinity::Any
+            ? linker_instance.add_func(function_name, std::move(linker_callback))
+            : linker_instance.add_func(function_name,
+                [linker_callback = std::move(linker_callback), affinity](
+                    wasmtime::Store::Context store_ctx, 
+                    const wasmtime::component::FuncType& func_type,
+                    wasmtime::Span<wasmtime::component::Val> args,
+                    wasmtime::Span<wasmtime::component::Val> results) -> wasmtime::Result<std::monostate> {
+                    ScopedHostCallAffinity affinity_scope(affinity);
+                    return linker_callback(store_ctx, func_type, args, results);
+                }
+            );
+        if (!result) {
+            Core::Logger::error("Failed to define component function {}.{}", interface_info.m_interface_name, function_name);
+        }
+        return result;
+    }
+
+    // Wrap a host callback so every call validates the guest's function type before any argument is touched. For
+    // consumers that pass m_host_callback to add_func themselves without running m_signature_validator first.
+    template<typename Callback>
+    auto makeCheckedHostCallback(Callback callback, InterfaceFunctionSignatureValidator validator)
+    {
+        return [callback, validator](
+            wasmtime::Store::Context store_ctx, 
+            const wasmtime::component::FuncType& call_func_type,
+            wasmtime::Span<wasmtime::component::Val> args,
+            wasmtime::Span<wasmtime::component::Val> results) -> wasmtime::Result<std::monostate> {
+            if (!validator(call_func_type) || args.size() < call_func_type.param_count() || results.size() < call_func_type.result_count()) {
+                static DiagnosticRateLimiter rate_limiter;
+                if (rate_limiter.shouldLog()) {
+                    Core::Logger::error("Signature mismatch on unvalidated host function call ({} occurrences)", rate_limiter.getCount());
+                }
+                return wasmtime::Error("signature mismatch for host function");
+            }
+            return callback(store_ctx, call_func_type, args, results);
+        };
+    }
+
+    // Check the type a component imports a function with against the member function's C++ signature
+    inline wasmtime::Result<std::monostate> validateComponentFunction(
+        const InterfaceExportInfo& interface_info,
+        const InterfaceFunctionExportInfo& function_info,
+        std::string_view function_name,
+        const wasmtime::component::FuncType& func_type,
+        bool is_batch)
+    {
+        const InterfaceFunctionSignatureValidator validator = 
+            is_batch ? function_info.m_batch_signature_validator : function_info.m_signature_validator;
+        if (!validator(func_type)) {
+            Core::Logger::error("Signature mismatch for {}.{}", interface_info.m_interface_name, function_name);
+            return wasmtime::Error(
+                std::string("signature mismatch for ") + interface_info.m_interface_name + "." + std::string(function_name)
+            );
+        }
+        return wasmtime::Result<std::monostate>(std::monostate{});
+    }
+
+    // Validate a function the component imports against its C++ signature and define it. Validation happens here
+    // once, so the per-call path can extract arguments unchecked. Without a func_type the definition was never
+    // validated, so the type wasmtime hands to each call is validated instead before anything is extracted.
+    inline wasmtime::Result<std::monostate> defineComponentFunction(
+        wasmtime::component::LinkerInstance& linker_instance,
+        const InterfaceExportInfo& interface_info,
+        const InterfaceFunctionExportInfo& function_info,
+        std::string_view function_name,
+        const wasmtime::component::FuncType* func_type,
+        bool is_batch)
+    {
+        if (func_type) {
+            auto validate_result = validateComponentFunction(interface_info, function_info, function_name, *func_type, is_batch);
+            if (!validate_result) {
+                return validate_result;
+            }
+        }
+        
+        const InterfaceFunctionSignatureValidator validator = 
+            is_batch ? function_info.m_batch_signature_validator : function_info.m_signature_validator;
+        const InterfaceFunctionHostCallback& host_callback = is_batch ? function_info.m_batch_host_callback : function_info.m_host_callback;
+        // Zones use the export info's own names, function_name may be a temporary batch name
+        auto linker_callback = 
+            makeLinkerCallback(host_callback, function_info.m_call_stats, interface_info.m_interface_name, function_info.m_function_name);
+        if (func_type) {
+            return addComponentLinkerCallback(linker_instance, interface_info, function_name, function_info.m_affinity, linker_callback);
+        }
+        
+        return addComponentLinkerCallback(
+            linker_instance, interface_info, function_name, function_info.m_affinity, makeCheckedHostCallback(linker_callback, validator)
+        );
+    }
+
+    // Define every component callback under its interface instance, for linkers shared by several components.
+    // Functions the given component imports are validated against their C++ signature once, every other function
+    // validates the type of each call, prefer defineImportedComponentExports where the linker serves one component.
+    inline wasmtime::Result<std::monostate> defineComponentExports(
+        const wasmtime::Engine& engine,
+        wasmtime::component::Linker& linker,
+        const wasmtime::component::Component& component,
+        const LinkerExportInfo& linker_export_info)
+    {
+        for (size_t i = 0; i < linker_export_info.m_interface_count; ++i) {
+            const InterfaceExportInfo& interface_info = linker_export_info.m_interface_array[i];
+            auto linker_instance = linker.root().add_instance(interface_info.m_interface_name);
+            if (!linker_instance) {
+                Core::Logger::error("Failed to add linker instance {}", interface_info.m_interface_name);
+                return wasmtime::Error(std::string("failed to add linker instance ") + interface_info.m_interface_name);
+            }
+            
+            for (size_t j = 0; j < interface_info.m_member_function_count; ++j) {
+                const InterfaceFunctionExportInfo& function_info = interface_info.m_member_function_array[j];
+                
+                auto func_type = findImportedFuncType(engine, component, interface_info.m_interface_name, function_info.m_function_name);
+                auto result = defineComponentFunction(
+                    linker_instance.ok(), interface_info, function_info, function_info.m_function_name, func_type ? &*func_type : nullptr, false
+                );
+                if (!result) {
+                    return result;
+                }
+                
+                // The batch variant is only defined when the component asks for it
+                std::string batch_function_name = std::string(function_info.m_function_name) + std::string(BatchFunctionSuffix);
+                auto batch_func_type = findImportedFuncType(engine, component, interface_info.m_interface_name, batch_function_name);
+                if (!batch_func_type) {
+                    continue;
+                }
+                
+                result = defineComponentFunction(linker_instance.ok(), interface_info, function_info, batch_function_name, &*batch_func_type, true);
+                if (!result) {
+                    return result;
+                }
+            }
+        }
+        return wasmtime::Result<std::monostate>(std::monostate{});
+    }
+
+    // Define only what the component imports. The import list is walked once and each imported interface instance
+    // and function is matched by name against the export info, so unused interfaces cost nothing beyond a name lookup.
+    // Imports without a matching export are left to other definers, instantiation reports them if nobody provides them.
+    inline wasmtime::Result<std::monostate> defineImportedComponentExports(
+        const wasmtime::Engine& engine,
+        wasmtime::component::Linker& linker,
+        const wasmtime::component::Component& component,
+        const LinkerExportInfo& linker_export_info)
+    {
+        std::unordered_map<std::string_view, const InterfaceExportInfo*> interface_by_name;
+        interface_by_name.reserve(linker_export_info.m_interface_count);
+        for (size_t i = 0; i < linker_export_info.m_interface_count; ++i) {
+            interface_by_name.emplace(linker_export_info.m_interface_array[i].m_interface_name, &linker_export_info.m_interface_array[i]);
+        }
+        
+        const auto component_type = component.type();
+        const size_t import_count = component_type.import_count(engine);
+        for (size_t i = 0; i < import_count; ++i) {
+            auto import_item = component_type.import_nth(engine, i);
+            if (!import_item || !import_item->second.is_component_instance()) {
+                continue;
+            }
+            
+            auto found_interface = interface_by_name.find(import_item->first);
+            if (found_interface == interface_by_name.end()) {
+                continue;
+            }
+            
+            const InterfaceExportInfo& interface_info = *found_interface->second;
+            auto linker_instance = linker.root().add_instance(interface_info.m_interface_name);
+            if (!linker_instance) {
+                Core::Logger::error("Failed to add linker instance {}", interface_info.m_interface_name);
+                return wasmtime::Error(std::string("failed to add linker instance ") + interface_info.m_interface_name);
+            }
+            
+            const auto instance_type = import_item->second.component_instance();
+            const size_t function_count = instance_type.export_count(engine);
+            for (size_t j = 0; j < function_count; ++j) {
+                auto function_item = instance_type.export_nth(engine, j);
+                if (!function_item || !function_item->second.is_component_func()) {
+                    continue;
+                }
+                
+                auto find_member = [&interface_info](std::string_view member_name) -> const InterfaceFunctionExportInfo*
+                {
+                    for (size_t k = 0; k < interface_info.m_member_function_count; ++k) {
+                        if (member_name == interface_info.m_member_function_array[k].m_function_name) {
+                            return &interface_info.m_member_function_array[k];
+                        }
+                    }
+                    return nullptr;
+                };
+                
+                // A member whose own name ends in the batch suffix takes precedence over a batch variant
+                std::string_view function_name = function_item->first;
+                const InterfaceFunctionExportInfo* function_info = find_member(function_name);
+                const bool is_batch = !function_info && function_name.ends_with(BatchFunctionSuffix);
+                if (is_batch) {
+                    function_info = find_member(function_name.substr(0, function_name.size() - BatchFunctionSuffix.size()));
+                }
+                if (!function_info) {
+                    continue;
+                }
+                
+                const auto func_type = function_item->second.component_func();
+                auto result = defineComponentFunction(linker_instance.ok(), interface_info, *function_info, function_name, &func_type, is_batch);
+                if (!result) {
+                    return result;
+                }
+            }
+        }
+        return wasmtime::Result<std::monostate>(std::monostate{});
+    }
+
+    // Define every core-compatible member function on a core wasm linker, one module per interface
+    inline wasmtime::Result<std::monostate> defineCoreWasmExports(wasmtime::Linker& linker, const LinkerExportInfo& linker_export_info)
+    {
+        for (size_t i = 0; i < linker_export_info.m_interface_count; ++i) {
+            const InterfaceExportInfo& interface_info = linker_export_info.m_interface_array[i];
+            for (size_t j = 0; j < interface_info.m_member_function_count; ++j) {
+                const InterfaceFunctionExportInfo& function_info = interface_info.m_member_function_array[j];
+                if (!function_info.m_core_definer) {
+                    continue;
+                }
+
+                auto result = function_info.m_core_definer(
+                    linker, 
+                    interface_info.m_interface_name, 
+                    function_info.m_function_name, 
+                    function_info.m_host_callback.getContext(),
+                    function_info.m_call_stats,
+                    function_info.m_affinity
+                );
+                if (!result) {
+                    Core::Logger::error("Failed to define core wasm function {}.{}", interface_info.m_interface_name, function_info.m_function_name);
+                    return result;
+                }
+            }
+        }
+        return wasmtime::Result<std::monostate>(std::monostate{});
+    }
+
+    // The returned table may live in the plugin's read-only data, consumers must not write through it
+    typedef const LinkerExportInfo* (*DLLExportLinkInterfacesFn)(std::uint64_t version_checksum);
 }
 
 
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "core/module/module.h"
+
+#include <wasmtime.hh>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <thread>
+
+namespace Arieo::Lib::WasmtimeLinker 
+{
+    // Linker-side policy bounding how long a guest call may run. Epochs are the cheap option: the engine-wide counter
+    // is bumped by EpochTicker (or the frame loop) and each store traps once its deadline passes. Fuel is
+    // deterministic but costs a counter update per wasm block.
+    // Interruption is terminal, not time slicing: without wasmtime's async support an exhausted deadline or fuel
+    // budget traps, and the interrupted call cannot be continued. A component instance that trapped may not be
+    // entered again, so the host drops it and instantiates afresh, e.g. from its ComponentInstancePre. The budget
+    // therefore has to cover a whole guest call, armStore only renews it between calls.
+    struct InterruptionPolicy
+    {
+        bool m_epoch_interruption = false;
+        uint64_t m_epoch_deadline_ticks = 1;    // Ticks a store may run after armStore before its current call traps
+        bool m_consume_fuel = false;
+        uint64_t m_fuel_per_slice = 0;          // Fuel given to a store by armStore, the call that exhausts it traps
+        uint64_t m_host_call_fuel_cost = 0;     // Fuel charged by every generated host callback, 0 disables charging
+    };
+
+    inline std::atomic<uint64_t>& getHostCallFuelCostStorage()
+    {
+        static std::atomic<uint64_t> host_call_fuel_cost{0};
+        return host_call_fuel_cost;
+    }
+
+    inline uint64_t getHostCallFuelCost()
+    {
+        return getHostCallFuelCostStorage().load(std::memory_order_relaxed);
+    }
+
+    // Configure the engine, must be called on the Config before the Engine is created
+    inline void applyInterruptionPolicy(wasmtime::Config& config, const InterruptionPolicy& policy)
+    {
+        config.epoch_interruption(policy.m_epoch_interruption);
+        config.consume_fuel(policy.m_consume_fuel);
+        getHostCallFuelCostStorage().store(policy.m_consume_fuel ? policy.m_host_call_fuel_cost : 0, std::memory_order_relaxed);
+    }
+
+    // Renew a store's budget before its next guest call, typically once per frame. This does not resume a call that
+    // was interrupted, that call has already trapped.
+    inline void armStore(wasmtime::Store::Context store_ctx, const InterruptionPolicy& policy)
+    {
+        if (policy.m_epoch_interruption) {
+            store_ctx.set_epoch_deadline(policy.m_epoch_deadline_ticks);
+        }
+        
+        if (policy.m_consume_fuel) {
+            auto result = store_ctx.set_fuel(policy.m_fuel_per_slice);
+            if (!result) {
+                Core::Logger::error("Failed to set store fuel: {}", result.err().message());
+            }
+        }
+    }
+
+    // Charge the host call fuel cost of call_count calls to the calling store, false when the store ran out of fuel.
+    // A single relaxed load when charging is disabled.
+    inline bool chargeHostCallFuel(wasmtime::Store::Context store_ctx, uint64_t call_count = 1)
+    {
+        const uint64_t cost = getHostCallFuelCost();
+        if (cost == 0 || call_count == 0) {
+            return true;
+        }
+        if (cost > std::numeric_limits<uint64_t>::max() / call_count) {
+            return false;
+        }
+        
+        const uint64_t total_cost = cost * call_count;
+        auto fuel = store_ctx.get_fuel();
+        if (!fuel || fuel.ok() < total_cost) {
+            return false;
+        }
+        return static_cast<bool>(store_ctx.set_fuel(fuel.ok() - total_cost));
+    }
+
+    // Background thread incrementing the engine epoch at a fixed period, so store deadlines map to wall time
+    class EpochTicker
+    {
+    public:
+        EpochTicker(const wasmtime::Engine& engine, std::chrono::microseconds period)
+            : m_thread([&engine, period, this]() {
+                while (!m_stop.load(std::memory_order_relaxed)) {
+                    std::this_thread::sleep_for(period);
+                    engine.increment_epoch();
+                }
+            })
+        {
+        }
+
+        ~EpochTicker()
+        {
+            m_stop.store(true, std::memory_order_relaxed);
+            m_thread.join();
+        }
+
+        EpochTicker(const EpochTicker&) = delete;
+        EpochTicker& operator=(const EpochTicker&) = delete;
+
+    private:
+        std::atomic<bool> m_stop{false};
+        std::thread m_thread;
+    };
+}
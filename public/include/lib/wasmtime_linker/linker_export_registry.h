@@ -0,0 +1,233 @@
+#pragma once
+
+#include "lib/wasmtime_linker/interface_wasmtime_linker.h"
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Arieo::Lib::WasmtimeLinker
+{
+    // Exports of every loaded plugin merged into one registry. Interface and function fields are kept in parallel
+    // arrays sorted by id, so a lookup binary searches a dense id array and dispatch reads one element of each
+    // consecutive callback array instead of chasing InterfaceExportInfo pointers into each plugin's data section.
+    // The same data is also offered as a single contiguous LinkerExportInfo for the define* helpers.
+    class LinkerExportRegistry
+    {
+    public:
+        // Add one plugin's exports. An interface exported by two plugins with the same checksum is kept once. A plugin
+        // name that is already registered, an interface id listed twice by the same plugin, a mismatching checksum,
+        // a function id repeated within one interface or a member array not sorted by function id as
+        // LinkerExportInfo requires rejects the whole plugin.
+        wasmtime::Result<std::monostate> addPlugin(std::string_view plugin_name, const LinkerExportInfo& linker_export_info)
+        {
+            if (std::any_of(m_plugins.begin(), m_plugins.end(), [plugin_name](const Plugin& plugin) { return plugin.m_name == plugin_name; })) {
+                Core::Logger::error("Plugin {} is already registered", plugin_name);
+                return wasmtime::Error(std::string("plugin ") + std::string(plugin_name) + " is already registered");
+            }
+
+            for (size_t i = 0; i < linker_export_info.m_interface_count; ++i) {
+                const InterfaceExportInfo& interface_info = linker_export_info.m_interface_array[i];
+                // Interfaces per plugin are few, a linear scan of the earlier entries is enough
+                for (size_t j = 0; j < i; ++j) {
+                    if (linker_export_info.m_interface_array[j].m_interaface_id == interface_info.m_interaface_id) {
+                        Core::Logger::error("Plugin {} lists {} twice, with checksums {} and {}", 
+                            plugin_name, interface_info.m_interface_name, 
+                            linker_export_info.m_interface_array[j].m_interface_checksum, interface_info.m_interface_checksum
+                        );
+                        return wasmtime::Error(std::string("duplicate interface ") + interface_info.m_interface_name + " in plugin " + std::string(plugin_name));
+                    }
+                }
+                
+                auto result = checkInterface(plugin_name, interface_info);
+                if (!result) {
+                    return result;
+                }
+            }
+
+            m_plugins.push_back(Plugin{std::string(plugin_name), &linker_export_info});
+            rebuild();
+            return wasmtime::Result<std::monostate>(std::monostate{});
+        }
+
+        void removePlugin(std::string_view plugin_name)
+        {
+            std::erase_if(m_plugins, [plugin_name](const Plugin& plugin) { return plugin.m_name == plugin_name; });
+            rebuild();
+        }
+
+        size_t getInterfaceCount() const { return m_interface_ids.size(); }
+        size_t getFunctionCount() const { return m_function_ids.size(); }
+
+        std::optional<size_t> findInterface(uint64_t interface_id) const
+        {
+            auto found = std::lower_bound(m_interface_ids.begin(), m_interface_ids.end(), interface_id);
+            if (found == m_interface_ids.end() || *found != interface_id) {
+                return std::nullopt;
+            }
+            return static_cast<size_t>(found - m_interface_ids.begin());
+        }
+
+        // Index into the function arrays, searched only within the interface's contiguous range
+        std::optional<size_t> findFunctionInInterface(size_t interface_index, uint64_t function_id) const
+        {
+            auto begin = m_function_ids.begin() + m_interface_function_begin[interface_index];
+            auto end = begin + m_interface_function_count[interface_index];
+            auto found = std::lower_bound(begin, end, function_id);
+            if (found == end || *found != function_id) {
+                return std::nullopt;
+            }
+            return static_cast<size_t>(found - m_function_ids.begin());
+        }
+
+        std::optional<size_t> findFunction(uint64_t interface_id, uint64_t function_id) const
+        {
+            auto interface_index = findInterface(interface_id);
+            return interface_index ? findFunctionInInterface(*interface_index, function_id) : std::nullopt;
+        }
+
+        uint64_t getInterfaceId(size_t interface_index) const { return m_interface_ids[interface_index]; }
+        uint64_t getInterfaceChecksum(size_t interface_index) const { return m_interface_checksums[interface_index]; }
+        const char* getInterfaceName(size_t interface_index) const { return m_interface_names[interface_index]; }
+
+        uint64_t getFunctionId(size_t function_index) const { return m_function_ids[function_index]; }
+        uint64_t getFunctionChecksum(size_t function_index) const { return m_function_checksums[function_index]; }
+        const InterfaceFunctionHostCallback& getHostCallback(size_t function_index) const { return m_host_callbacks[function_index]; }
+
+        // Full export entry, for the colder fields such as validators and core definers
+        const InterfaceFunctionExportInfo& getFunctionExportInfo(size_t function_index) const { return m_function_export_array[function_index]; }
+
+        // Contiguous merged view, valid until the next addPlugin/removePlugin
+        const LinkerExportInfo& getLinkerExportInfo() const { return m_linker_export_info; }
+
+    private:
+        struct Plugin
+        {
+            std::string m_name;
+            const LinkerExportInfo* m_linker_export_info;
+        };
+
+        wasmtime::Result<std::monostate> checkInterface(std::string_view plugin_name, const InterfaceExportInfo& interface_info) const
+        {
+            for (size_t j = 1; j < interface_info.m_member_function_count; ++j) {
+                const InterfaceFunctionExportInfo& previous_info = interface_info.m_member_function_array[j - 1];
+                const InterfaceFunctionExportInfo& function_info = interface_info.m_member_function_array[j];
+                // Duplicates are only adjacent in a sorted array, and lookups binary search it
+                if (function_info.m_function_id < previous_info.m_function_id) {
+                    Core::Logger::error("Plugin {} exports the functions of {} unsorted, function id {} follows {}", 
+                        plugin_name, interface_info.m_interface_name, function_info.m_function_id, previous_info.m_function_id
+                    );
+                    return wasmtime::Error(std::string("functions of ") + interface_info.m_interface_name + " are not sorted by id");
+                }
+                if (function_info.m_function_id == previous_info.m_function_id) {
+                    Core::Logger::error("Plugin {} exports function id {} twice in {}", plugin_name, function_info.m_function_id, interface_info.m_interface_name);
+                    return wasmtime::Error(
+                        std::string("duplicate function ") + function_info.m_function_name + " in " + interface_info.m_interface_name
+                    );
+                }
+            }
+
+            auto interface_index = findInterface(interface_info.m_interaface_id);
+            if (interface_index && m_interface_checksums[*interface_index] != interface_info.m_interface_checksum) {
+                Core::Logger::error("Plugin {} exports {} with checksum {}, already registered with checksum {}",
+                    plugin_name, interface_info.m_interface_name, interface_info.m_interface_checksum, m_interface_checksums[*interface_index]
+                );
+                return wasmtime::Error(std::string("conflicting exports of interface ") + interface_info.m_interface_name);
+            }
+            if (interface_index) {
+                Core::Logger::warn("Plugin {} exports {} again, keeping the first registration", plugin_name, interface_info.m_interface_name);
+            }
+            return wasmtime::Result<std::monostate>(std::monostate{});
+        }
+
+        void rebuild()
+        {
+            // First registration of each interface id wins, plugins are visited in load order
+            std::vector<const InterfaceExportInfo*> interfaces;
+            for (const Plugin& plugin : m_plugins) {
+                for (size_t i = 0; i < plugin.m_linker_export_info->m_interface_count; ++i) {
+                    interfaces.push_back(&plugin.m_linker_export_info->m_interface_array[i]);
+                }
+            }
+            std::stable_sort(interfaces.begin(), interfaces.end(),
+                [](const InterfaceExportInfo* lhs, const InterfaceExportInfo* rhs) { return lhs->m_interaface_id < rhs->m_interaface_id; }
+            );
+            interfaces.erase(
+                std::unique(interfaces.begin(), interfaces.end(),
+                    [](const InterfaceExportInfo* lhs, const InterfaceExportInfo* rhs) { return lhs->m_interaface_id == rhs->m_interaface_id; }
+                ),
+                interfaces.end()
+            );
+
+            const size_t function_count = std::accumulate(interfaces.begin(), interfaces.end(), size_t(0),
+                [](size_t count, const InterfaceExportInfo* interface_info) { return count + interface_info->m_member_function_count; }
+            );
+
+            m_interface_ids.clear();
+            m_interface_checksums.clear();
+            m_interface_names.clear();
+            m_interface_function_begin.clear();
+            m_interface_function_count.clear();
+            m_interface_export_array.clear();
+            m_function_ids.clear();
+            m_function_checksums.clear();
+            m_host_callbacks.clear();
+            m_function_export_array.clear();
+
+            m_interface_ids.reserve(interfaces.size());
+            m_interface_checksums.reserve(interfaces.size());
+            m_interface_names.reserve(interfaces.size());
+            m_interface_function_begin.reserve(interfaces.size());
+            m_interface_function_count.reserve(interfaces.size());
+            m_interface_export_array.reserve(interfaces.size());
+            m_function_ids.reserve(function_count);
+            m_function_checksums.reserve(function_count);
+            m_host_callbacks.reserve(function_count);
+            m_function_export_array.reserve(function_count);
+
+            for (const InterfaceExportInfo* interface_info : interfaces) {
+                m_interface_ids.push_back(interface_info->m_interaface_id);
+                m_interface_checksums.push_back(interface_info->m_interface_checksum);
+                m_interface_names.push_back(interface_info->m_interface_name);
+                m_interface_function_begin.push_back(m_function_ids.size());
+                m_interface_function_count.push_back(interface_info->m_member_function_count);
+
+                // Member arrays are already sorted by function id, see LinkerExportInfo
+                for (size_t j = 0; j < interface_info->m_member_function_count; ++j) {
+                    const InterfaceFunctionExportInfo& function_info = interface_info->m_member_function_array[j];
+                    m_function_ids.push_back(function_info.m_function_id);
+                    m_function_checksums.push_back(function_info.m_function_checksum);
+                    m_host_callbacks.push_back(function_info.m_host_callback);
+                    m_function_export_array.push_back(function_info);
+                }
+            }
+
+            // Member array pointers are patched only once the function array has stopped growing
+            for (size_t i = 0; i < interfaces.size(); ++i) {
+                InterfaceExportInfo interface_info = *interfaces[i];
+                interface_info.m_member_function_array = m_function_export_array.data() + m_interface_function_begin[i];
+                m_interface_export_array.push_back(interface_info);
+            }
+            m_linker_export_info = LinkerExportInfo{m_interface_export_array.data(), m_interface_export_array.size()};
+        }
+
+        std::vector<Plugin> m_plugins;
+
+        std::vector<uint64_t> m_interface_ids;
+        std::vector<uint64_t> m_interface_checksums;
+        std::vector<const char*> m_interface_names;
+        std::vector<size_t> m_interface_function_begin;
+        std::vector<size_t> m_interface_function_count;
+
+        std::vector<uint64_t> m_function_ids;
+        std::vector<uint64_t> m_function_checksums;
+        std::vector<InterfaceFunctionHostCallback> m_host_callbacks;
+
+        std::vector<InterfaceExportInfo> m_interface_export_array;
+        std::vector<InterfaceFunctionExportInfo> m_function_export_array;
+        LinkerExportInfo m_linker_export_info{nullptr, 0};
+    };
+}
@@ -0,0 +1,47 @@
+// Compile-time checks of which span parameters the core wasm path may alias straight into guest memory. The
+// rejected cases would let a guest write values the host type cannot hold: forged pointers and bools other than
+// 0 or 1. Building this file is the test, main only reports success.
+
+#include "lib/wasmtime_linker/interface_wasmtime_linker.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string_view>
+
+using namespace Arieo::Lib::WasmtimeLinker;
+
+namespace
+{
+    struct ScalarRecord { float x; float y; int32_t id; };
+    struct NestedScalarRecord { ScalarRecord position; uint64_t flags; };
+    struct PointerRecord { const char* name; int32_t id; };
+    struct BoolRecord { float weight; bool enabled; };
+    struct NestedBoolRecord { ScalarRecord position; BoolRecord state; };
+}
+
+static_assert(is_guest_memory_view_v<std::string_view>);
+static_assert(is_guest_memory_view_v<std::span<const float>>);
+static_assert(is_guest_memory_view_v<std::span<const int32_t>>);
+static_assert(is_guest_memory_view_v<std::span<const uint8_t>>);
+static_assert(is_guest_memory_view_v<std::span<const std::byte>>);
+static_assert(is_guest_memory_view_v<std::span<const ScalarRecord>>);
+static_assert(is_guest_memory_view_v<std::span<const NestedScalarRecord>>);
+
+static_assert(!is_guest_memory_view_v<std::span<const bool>>, "any guest byte other than 0 or 1 is not a valid bool");
+static_assert(!is_guest_memory_view_v<std::span<const void* const>>, "guest-written pointers are forged host addresses");
+static_assert(!is_guest_memory_view_v<std::span<const PointerRecord>>, "records with pointer fields must not alias guest memory");
+static_assert(!is_guest_memory_view_v<std::span<const BoolRecord>>, "records with bool fields must not alias guest memory");
+static_assert(!is_guest_memory_view_v<std::span<const NestedBoolRecord>>, "nested bool fields must not alias guest memory");
+
+// Functions taking a rejected span have no core wasm signature, so no core definer aliases their arguments
+static_assert(is_core_wasm_signature_v<void, std::span<const float>>);
+static_assert(!is_core_wasm_signature_v<void, std::span<const bool>>);
+static_assert(!is_core_wasm_signature_v<void, std::span<const PointerRecord>>);
+
+int main()
+{
+    std::printf("guest_memory_view_traits_test: passed\n");
+    return 0;
+}
@@ -0,0 +1,79 @@
+// A handle must never resolve once removed, however often its slot is reused. Cycles insert/remove on a small
+// table until every slot has exhausted its generations and check that no handle is handed out twice, that every
+// removed handle stays dead and that exhausted slots are retired rather than wrapped.
+
+#include "lib/wasmtime_linker/interface_handle_table.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <unordered_set>
+#include <vector>
+
+using namespace Arieo::Lib::WasmtimeLinker;
+
+namespace
+{
+    int fail(const char* message)
+    {
+        std::fprintf(stderr, "handle_table_generation_test: %s\n", message);
+        return 1;
+    }
+}
+
+int main()
+{
+    // Capacity 4 leaves slots 1 to 3, slot 0 is reserved for the invalid handle
+    constexpr uint32_t Capacity = 4;
+    constexpr uint32_t SlotCount = Capacity - 1;
+    constexpr uint64_t HandleCount = uint64_t(SlotCount) * (uint64_t(InterfaceHandleTable::MaxGeneration) + 1);
+
+    InterfaceHandleTable table(Capacity);
+    int instance = 0;
+
+    // Create/destroy one instance at a time, the pattern that reuses the same slot immediately
+    std::unordered_set<uint32_t> issued_handles;
+    std::vector<uint32_t> removed_handles;
+    removed_handles.reserve(HandleCount);
+    while (true) {
+        const uint32_t handle = table.insert(&instance);
+        if (handle == 0) {
+            break;
+        }
+        if (!issued_handles.insert(handle).second) {
+            std::fprintf(stderr, "handle_table_generation_test: handle 0x%x issued twice after %zu handles\n", 
+                handle, removed_handles.size());
+            return 1;
+        }
+        if (table.resolve(handle) != &instance) {
+            return fail("a new handle does not resolve to its instance");
+        }
+        if (table.remove(handle) != &instance) {
+            return fail("removing a live handle did not return its instance");
+        }
+        removed_handles.push_back(handle);
+    }
+
+    if (removed_handles.size() != HandleCount) {
+        std::fprintf(stderr, "handle_table_generation_test: %zu handles issued, expected %llu\n", 
+            removed_handles.size(), static_cast<unsigned long long>(HandleCount));
+        return 1;
+    }
+
+    for (uint32_t handle : removed_handles) {
+        if (table.resolve(handle) != nullptr) {
+            std::fprintf(stderr, "handle_table_generation_test: removed handle 0x%x resolves again\n", handle);
+            return 1;
+        }
+        if (table.remove(handle) != nullptr) {
+            return fail("a removed handle was removed twice");
+        }
+    }
+
+    if (table.getRetiredCount() != SlotCount) {
+        std::fprintf(stderr, "handle_table_generation_test: %u slots retired, expected %u\n", table.getRetiredCount(), SlotCount);
+        return 1;
+    }
+    std::printf("handle_table_generation_test: %llu handles issued, %u slots retired\n", 
+        static_cast<unsigned long long>(HandleCount), table.getRetiredCount());
+    return 0;
+}
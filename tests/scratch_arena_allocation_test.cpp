@@ -0,0 +1,248 @@
+// Steady-state host calls must not grow the scratch arena: after the first call has sized it, decoding a
+// std::span<const E> argument of the same length reuses the arena blocks and getHeapAllocationCount stays flat.
+// Record and tuple results are built as wasmtime Vals outside the arena, their calls must leave it untouched too.
+// list<bool> decodes into a plain bool array rather than a packed vector<bool>, so it can back std::span<const bool>.
+
+#include "lib/wasmtime_linker/interface_wasmtime_linker.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    struct ScratchArenaTestPoint
+    {
+        float x;
+        float y;
+    };
+
+    struct ScratchArenaTestInterface
+    {
+        float sum(std::span<const float> values)
+        {
+            float total = 0.0f;
+            for (float value : values) {
+                total += value;
+            }
+            return total;
+        }
+
+        uint32_t countSet(std::span<const bool> flags)
+        {
+            uint32_t count = 0;
+            for (bool flag : flags) {
+                count += flag ? 1 : 0;
+            }
+            return count;
+        }
+
+        ScratchArenaTestPoint makePoint(float x, float y) { return ScratchArenaTestPoint{x, y}; }
+        std::tuple<int32_t, float> makePair(int32_t value) { return {value, float(value) * 0.5f}; }
+    };
+
+    constexpr std::string_view TestInterfaceName = "arieo:test/scratch-arena";
+    constexpr uint32_t ValueCount = 256;
+    constexpr uint32_t CallCount = 1000;
+}
+
+template<>
+struct Arieo::Base::InterfaceInfo<ScratchArenaTestInterface>
+{
+    static constexpr std::string_view getWitFullInterfaceName() { return TestInterfaceName; }
+    static constexpr std::size_t getMemberFunctionCount() { return 4; }
+    static constexpr std::uint64_t getInterfaceId() { return 0x7465737400000001ull; }
+    static constexpr std::uint64_t getInterfaceChecksum() { return 1; }
+
+    template<typename Fn>
+    static void iteratorMemberFunctions(Fn&& fn)
+    {
+        fn(&ScratchArenaTestInterface::sum, "sum", "sum", 1, 1);
+        fn(&ScratchArenaTestInterface::makePoint, "makePoint", "make-point", 2, 1);
+        fn(&ScratchArenaTestInterface::makePair, "makePair", "make-pair", 3, 1);
+        fn(&ScratchArenaTestInterface::countSet, "countSet", "count-set", 4, 1);
+    }
+};
+
+using namespace Arieo::Lib::WasmtimeLinker;
+
+namespace
+{
+    using TestInstanceArg = InstanceArgType<ScratchArenaTestInterface>;
+    constexpr bool TestUsesHandles = InterfaceInstanceBinding<ScratchArenaTestInterface>::use_handle_table;
+
+    std::string makeTestComponentWat()
+    {
+        const std::string instance_type = TestUsesHandles ? "u32" : "s64";
+        return std::string("(component (import \"") + std::string(TestInterfaceName) + "\" (instance\n"
+            "  (type $point-type (record (field \"x\" f32) (field \"y\" f32)))\n"
+            "  (export \"point\" (type $point (eq $point-type)))\n"
+            "  (export \"sum\" (func (param \"instance\" " + instance_type + ") (param \"values\" (list f32)) (result f32)))\n"
+            "  (export \"make-point\" (func (param \"instance\" " + instance_type + ") (param \"x\" f32) (param \"y\" f32) (result $point)))\n"
+            "  (export \"make-pair\" (func (param \"instance\" " + instance_type + ") (param \"value\" s32) (result (tuple s32 f32))))\n"
+            "  (export \"count-set\" (func (param \"instance\" " + instance_type + ") (param \"flags\" (list bool)) (result u32)))\n"
+            ")))\n";
+    }
+
+    int fail(std::string_view function_name, const char* message)
+    {
+        std::fprintf(stderr, "scratch_arena_allocation_test: %.*s: %s\n", static_cast<int>(function_name.size()), function_name.data(), message);
+        return 1;
+    }
+
+    // Call once to size the arena, then CallCount times, checking every result and that the arena never grows.
+    // Returns the number of arena blocks the warm-up call needed, or -1 after reporting a failure.
+    template<typename CheckResult>
+    long runSteadyState(
+        std::string_view function_name,
+        const InterfaceFunctionHostCallback& callback,
+        wasmtime::Store& store,
+        const wasmtime::component::FuncType& func_type,
+        std::vector<wasmtime::component::Val>& args,
+        std::vector<wasmtime::component::Val>& results,
+        const InterfaceScratchArena& arena,
+        CheckResult&& check_result)
+    {
+        if (!callback(store.context(), func_type, args, results) || !check_result(results[0])) {
+            fail(function_name, "warm-up call failed");
+            return -1;
+        }
+        const std::size_t warm_allocation_count = arena.getHeapAllocationCount();
+        const std::size_t warm_high_water_mark = arena.getHighWaterMark();
+
+        for (uint32_t i = 0; i < CallCount; ++i) {
+            if (!callback(store.context(), func_type, args, results)) {
+                fail(function_name, "host call failed");
+                return -1;
+            }
+            if (!check_result(results[0])) {
+                fail(function_name, "host call returned a wrong result");
+                return -1;
+            }
+        }
+
+        if (arena.getHeapAllocationCount() != warm_allocation_count || arena.getHighWaterMark() != warm_high_water_mark) {
+            std::fprintf(stderr, "scratch_arena_allocation_test: %.*s: arena grew from %zu to %zu blocks over %u calls\n",
+                static_cast<int>(function_name.size()), function_name.data(), warm_allocation_count, arena.getHeapAllocationCount(), CallCount);
+            return -1;
+        }
+        std::printf("scratch_arena_allocation_test: %.*s: %u calls, %zu arena blocks, %zu bytes high water mark\n",
+            static_cast<int>(function_name.size()), function_name.data(), CallCount, warm_allocation_count, warm_high_water_mark);
+        return static_cast<long>(warm_allocation_count);
+    }
+}
+
+int main()
+{
+    wasmtime::Engine engine;
+    auto component_bytes = wasmtime::wat2wasm(makeTestComponentWat());
+    if (!component_bytes) {
+        return fail("component", "failed to assemble the test component");
+    }
+    auto component = wasmtime::component::Component::compile(engine, component_bytes.ok());
+    if (!component) {
+        return fail("component", "failed to compile the test component");
+    }
+
+    auto sum_type = findImportedFuncType(engine, component.ok(), TestInterfaceName, "sum");
+    auto point_type = findImportedFuncType(engine, component.ok(), TestInterfaceName, "make-point");
+    auto pair_type = findImportedFuncType(engine, component.ok(), TestInterfaceName, "make-pair");
+    auto count_type = findImportedFuncType(engine, component.ok(), TestInterfaceName, "count-set");
+    if (!sum_type || !generateSignatureValidator<&ScratchArenaTestInterface::sum>()(*sum_type) ||
+        !point_type || !generateSignatureValidator<&ScratchArenaTestInterface::makePoint>()(*point_type) ||
+        !pair_type || !generateSignatureValidator<&ScratchArenaTestInterface::makePair>()(*pair_type) ||
+        !count_type || !generateSignatureValidator<&ScratchArenaTestInterface::countSet>()(*count_type)) {
+        return fail("component", "imported function types do not match the host signatures");
+    }
+
+    ScratchArenaTestInterface host;
+    TestInstanceArg instance_value = 0;
+    if constexpr (TestUsesHandles) {
+        instance_value = getInterfaceHandleTable<ScratchArenaTestInterface>().insert(&host);
+    } else {
+        instance_value = static_cast<TestInstanceArg>(reinterpret_cast<intptr_t>(&host));
+    }
+
+    wasmtime::Store store(engine);
+    InterfaceScratchArena arena;
+    ScopedInterfaceScratchArena scoped_arena(arena);
+
+    // A span argument is decoded into the arena, so the warm-up call must have taken at least one block
+    std::vector<wasmtime::component::Val> values;
+    values.reserve(ValueCount);
+    for (uint32_t i = 0; i < ValueCount; ++i) {
+        values.emplace_back(1.0f);
+    }
+    std::vector<wasmtime::component::Val> sum_args{
+        wasmtime::component::Val(instance_value), wasmtime::component::Val(wasmtime::component::List(std::move(values)))
+    };
+    std::vector<wasmtime::component::Val> sum_results{wasmtime::component::Val(0.0f)};
+    const long sum_blocks = runSteadyState("sum", generateCallback<&ScratchArenaTestInterface::sum, CallbackMode::Fast>(),
+        store, *sum_type, sum_args, sum_results, arena,
+        [](const wasmtime::component::Val& result) { return result.get_f32() == float(ValueCount); }
+    );
+    if (sum_blocks < 0) {
+        return 1;
+    }
+    if (sum_blocks == 0 || arena.getHighWaterMark() < ValueCount * sizeof(float)) {
+        return fail("sum", "the span argument was not decoded into the installed arena");
+    }
+
+    std::vector<wasmtime::component::Val> point_args{
+        wasmtime::component::Val(instance_value), wasmtime::component::Val(1.5f), wasmtime::component::Val(-2.0f)
+    };
+    std::vector<wasmtime::component::Val> point_results{wasmtime::component::Val(0.0f)};
+    if (runSteadyState("make-point", generateCallback<&ScratchArenaTestInterface::makePoint, CallbackMode::Fast>(),
+        store, *point_type, point_args, point_results, arena,
+        [](const wasmtime::component::Val& result) {
+            if (!result.is_record() || result.get_record().size() != 2) {
+                return false;
+            }
+            const wasmtime::component::RecordField* fields = result.get_record().begin();
+            return fields[0].name() == "x" && fields[0].value().get_f32() == 1.5f && 
+                fields[1].name() == "y" && fields[1].value().get_f32() == -2.0f;
+        }) < 0) {
+        return 1;
+    }
+
+    std::vector<wasmtime::component::Val> pair_args{wasmtime::component::Val(instance_value), wasmtime::component::Val(int32_t(6))};
+    std::vector<wasmtime::component::Val> pair_results{wasmtime::component::Val(0.0f)};
+    if (runSteadyState("make-pair", generateCallback<&ScratchArenaTestInterface::makePair, CallbackMode::Fast>(),
+        store, *pair_type, pair_args, pair_results, arena,
+        [](const wasmtime::component::Val& result) {
+            if (!result.is_tuple() || result.get_tuple().size() != 2) {
+                return false;
+            }
+            const wasmtime::component::Val* elements = result.get_tuple().begin();
+            return elements[0].get_s32() == 6 && elements[1].get_f32() == 3.0f;
+        }) < 0) {
+        return 1;
+    }
+
+    // Every third flag set, the bool array comes from the arena like any other decoded list
+    std::vector<wasmtime::component::Val> flags;
+    flags.reserve(ValueCount);
+    for (uint32_t i = 0; i < ValueCount; ++i) {
+        flags.emplace_back(i % 3 == 0);
+    }
+    const uint32_t set_count = (ValueCount + 2) / 3;
+    std::vector<wasmtime::component::Val> count_args{
+        wasmtime::component::Val(instance_value), wasmtime::component::Val(wasmtime::component::List(std::move(flags)))
+    };
+    std::vector<wasmtime::component::Val> count_results{wasmtime::component::Val(uint32_t(0))};
+    const auto check_count = [set_count](const wasmtime::component::Val& result) { return result.get_u32() == set_count; };
+    if (runSteadyState("count-set", generateCallback<&ScratchArenaTestInterface::countSet, CallbackMode::Fast>(),
+        store, *count_type, count_args, count_results, arena, check_count) < 0 ||
+        runSteadyState("count-set (diagnostic)", generateCallback<&ScratchArenaTestInterface::countSet, CallbackMode::Diagnostic>(),
+        store, *count_type, count_args, count_results, arena, check_count) < 0) {
+        return 1;
+    }
+
+    if constexpr (TestUsesHandles) {
+        getInterfaceHandleTable<ScratchArenaTestInterface>().remove(instance_value);
+    }
+    return 0;
+}